@@ -0,0 +1,286 @@
+#include "BinaryConfigMap.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  static const char magic[4] = {'X', 'C', 'M', 'B'};
+  static const uint32_t byteOrderCheck = 0x01020304;
+
+  enum Tag {TAG_MAP = 'M', TAG_VECTOR = 'V', TAG_INT = 'i', TAG_UINT = 'u',
+            TAG_DOUBLE = 'd', TAG_ULONG = 'l', TAG_STRING = 's',
+            TAG_BOOL = 'b', TAG_UNDEFINED = 'n'};
+
+  class BinaryWriter {
+  public:
+    std::string out;
+
+    template<typename T> void write(T v) {
+      out.append((const char*)&v, sizeof(T));
+    }
+
+    void writeSize(uint64_t v) {
+      // variable length encoding, seven bits per byte
+      while(v >= 0x80) {
+        out.push_back((char)((v & 0x7f) | 0x80));
+        v >>= 7;
+      }
+      out.push_back((char)v);
+    }
+
+    void writeString(const std::string &s) {
+      std::unordered_map<std::string, uint64_t>::iterator it = ids.find(s);
+      if(it != ids.end()) {
+        writeSize(it->second);
+        return;
+      }
+      // a new string is announced by the next free index
+      uint64_t id = ids.size();
+      ids[s] = id;
+      writeSize(id);
+      writeSize(s.size());
+      out.append(s);
+    }
+
+    void writeItem(ConfigItem &item) {
+      if(item.isMap()) {
+        writeMap(item);
+      }
+      else if(item.isVector()) {
+        ConfigVector &v = item;
+        out.push_back(TAG_VECTOR);
+        writeSize(v.size());
+        for(ConfigVector::iterator it=v.begin(); it!=v.end(); ++it) {
+          writeItem(*it);
+        }
+      }
+      else if(item.isAtom()) {
+        switch(item.getType()) {
+        case ConfigAtom::INT_TYPE:
+          out.push_back(TAG_INT);
+          write<int32_t>(item.getInt());
+          break;
+        case ConfigAtom::UINT_TYPE:
+          out.push_back(TAG_UINT);
+          write<uint32_t>(item.getUInt());
+          break;
+        case ConfigAtom::DOUBLE_TYPE:
+          out.push_back(TAG_DOUBLE);
+          write<double>(item.getDouble());
+          break;
+        case ConfigAtom::ULONG_TYPE:
+          out.push_back(TAG_ULONG);
+          write<uint64_t>(item.getULong());
+          break;
+        case ConfigAtom::BOOL_TYPE:
+          out.push_back(TAG_BOOL);
+          write<uint8_t>(item.getBool());
+          break;
+        case ConfigAtom::STRING_TYPE:
+          out.push_back(TAG_STRING);
+          writeString(item.getString());
+          break;
+        default:
+          out.push_back(TAG_UNDEFINED);
+          break;
+        }
+      }
+      else {
+        out.push_back(TAG_UNDEFINED);
+      }
+    }
+
+    void writeMap(ConfigMap &map) {
+      out.push_back(TAG_MAP);
+      writeSize(map.size());
+      for(ConfigMap::iterator it=map.begin(); it!=map.end(); ++it) {
+        writeString(it->first);
+        writeItem(it->second);
+      }
+    }
+
+  private:
+    std::unordered_map<std::string, uint64_t> ids;
+  };
+
+  class BinaryReader {
+  public:
+    BinaryReader(const std::string &data) : p(data.data()),
+                                            end(data.data()+data.size()) {}
+
+    template<typename T> T read() {
+      check(sizeof(T));
+      T v;
+      memcpy(&v, p, sizeof(T));
+      p += sizeof(T);
+      return v;
+    }
+
+    uint64_t readSize() {
+      uint64_t v = 0;
+      for(int shift=0; shift<64; shift+=7) {
+        uint8_t b = read<uint8_t>();
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if(!(b & 0x80)) return v;
+      }
+      throw std::runtime_error("invalid size");
+    }
+
+    const std::string& readString() {
+      uint64_t id = readSize();
+      if(id < strings.size()) {
+        return strings[id];
+      }
+      if(id != strings.size()) {
+        throw std::runtime_error("invalid string reference");
+      }
+      uint64_t size = readSize();
+      check(size);
+      strings.push_back(std::string(p, size));
+      p += size;
+      return strings.back();
+    }
+
+    void readItem(ConfigItem &item) {
+      char tag = read<char>();
+      switch(tag) {
+      case TAG_MAP:
+        {
+          ConfigMap map;
+          readMapContent(map);
+          item = map;
+          break;
+        }
+      case TAG_VECTOR:
+        {
+          uint64_t size = readSize();
+          ConfigVector v;
+          for(uint64_t i=0; i<size; ++i) {
+            ConfigItem child;
+            readItem(child);
+            v.push_back(child);
+          }
+          item = v;
+          break;
+        }
+      case TAG_INT:
+        item = (int)read<int32_t>();
+        break;
+      case TAG_UINT:
+        item = (unsigned int)read<uint32_t>();
+        break;
+      case TAG_DOUBLE:
+        item = read<double>();
+        break;
+      case TAG_ULONG:
+        item = (unsigned long)read<uint64_t>();
+        break;
+      case TAG_BOOL:
+        item = (bool)read<uint8_t>();
+        break;
+      case TAG_STRING:
+        item = readString();
+        break;
+      case TAG_UNDEFINED:
+        break;
+      default:
+        throw std::runtime_error("invalid tag");
+      }
+    }
+
+    void readMap(ConfigMap &map) {
+      if(read<char>() != TAG_MAP) {
+        throw std::runtime_error("invalid root");
+      }
+      readMapContent(map);
+    }
+
+  private:
+    const char *p, *end;
+    std::vector<std::string> strings;
+
+    void check(uint64_t size) {
+      if(size > (uint64_t)(end-p)) {
+        throw std::runtime_error("unexpected end of data");
+      }
+    }
+
+    void readMapContent(ConfigMap &map) {
+      uint64_t size = readSize();
+      for(uint64_t i=0; i<size; ++i) {
+        std::string key = readString();
+        readItem(map[key]);
+      }
+    }
+  };
+
+  std::string BinaryConfigMap::toBinaryString(ConfigMap &map) {
+    BinaryWriter writer;
+    writer.out.append(magic, 4);
+    writer.write<uint32_t>(byteOrderCheck);
+    writer.writeMap(map);
+    return writer.out;
+  }
+
+  bool BinaryConfigMap::fromBinaryString(const std::string &data,
+                                         ConfigMap &map) {
+    if(data.size() < 8 || memcmp(data.data(), magic, 4) != 0) {
+      return false;
+    }
+    try {
+      BinaryReader reader(data);
+      for(int i=0; i<4; ++i) reader.read<char>();
+      if(reader.read<uint32_t>() != byteOrderCheck) {
+        return false;
+      }
+      ConfigMap result;
+      reader.readMap(result);
+      map = result;
+    } catch(std::exception &e) {
+      fprintf(stderr, "ERROR: reading binary config map: %s\n", e.what());
+      return false;
+    }
+    return true;
+  }
+
+  bool BinaryConfigMap::toBinaryFile(ConfigMap &map,
+                                     const std::string &filename) {
+    // readers never see a partly written file
+    std::string tmpFile = filename + ".tmp";
+    {
+      std::ofstream file(tmpFile.c_str(), std::ios::binary);
+      if(!file.good()) return false;
+      std::string data = toBinaryString(map);
+      file.write(data.data(), data.size());
+      file.close();
+      if(!file) {
+        remove(tmpFile.c_str());
+        return false;
+      }
+    }
+    if(rename(tmpFile.c_str(), filename.c_str()) != 0) {
+      remove(tmpFile.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool BinaryConfigMap::fromBinaryFile(const std::string &filename,
+                                       ConfigMap &map) {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if(!file.good()) return false;
+    std::stringstream data;
+    data << file.rdbuf();
+    return fromBinaryString(data.str(), map);
+  }
+
+} // end of namespace xrock_gui_model
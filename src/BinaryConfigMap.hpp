@@ -0,0 +1,35 @@
+/**
+ * \file BinaryConfigMap.hpp
+ * \brief Compact binary serialization of config maps
+ *
+ * The format is a tagged tree. Keys and string values are written once
+ * and referenced by index afterwards. Numbers are stored in native byte
+ * order; the header contains a check to reject data written on a machine
+ * with a different byte order.
+ **/
+
+#ifndef XROCK_GUI_MODEL_BINARY_CONFIG_MAP_HPP
+#define XROCK_GUI_MODEL_BINARY_CONFIG_MAP_HPP
+
+#include <configmaps/ConfigData.h>
+
+#include <string>
+
+namespace xrock_gui_model {
+
+  class BinaryConfigMap {
+  public:
+    static std::string toBinaryString(configmaps::ConfigMap &map);
+    // returns false if the data is not a valid binary config map
+    static bool fromBinaryString(const std::string &data,
+                                 configmaps::ConfigMap &map);
+
+    static bool toBinaryFile(configmaps::ConfigMap &map,
+                             const std::string &filename);
+    static bool fromBinaryFile(const std::string &filename,
+                               configmaps::ConfigMap &map);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_BINARY_CONFIG_MAP_HPP
@@ -0,0 +1,449 @@
+#include "CndExport.hpp"
+#include "ConfigMapHelper.hpp"
+#include "DBInterface.hpp"
+#include "PhaseTimer.hpp"
+
+#include <mars/utils/misc.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  // <package>::<task> becomes orogen_default_<package>__<task>
+  static std::string defaultProcessName(const std::string &type) {
+    std::vector<std::string> arrName = mars::utils::explodeString(':', type);
+    if(arrName.size() < 3) {
+      return "orogen_default_" + mars::utils::replaceString(type, ":", "_");
+    }
+    return "orogen_default_"+arrName[0]+"__"+arrName[2];
+  }
+
+  static bool writeYaml(const ConfigMap &map, const std::string &filename) {
+    std::ofstream out(filename.c_str());
+    out << map.toYamlString();
+    out.close();
+    if(!out) {
+      fprintf(stderr, "ERROR: could not write %s\n", filename.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  static void trimMap(ConfigItem &item) {
+    if(item.isMap()) {
+      ConfigMap::iterator it = item.beginMap();
+      while(it != item.endMap()) {
+        if(it->second.isAtom()) {
+          std::string value = mars::utils::trim(it->second.toString());
+          if(value.empty()) {
+            item.erase(it);
+            it = item.beginMap();
+          }
+          else {
+            ++it;
+          }
+        }
+        else if(it->second.isMap() || it->second.isVector()) {
+          // todo: handle empty map
+          trimMap(it->second);
+          if(it->second.size() == 0) {
+            item.erase(it);
+            it = item.beginMap();
+          }
+          else {
+            ++it;
+          }
+        }
+        else {
+          item.erase(it);
+          it = item.beginMap();
+        }
+      }
+    }
+    else if(item.isVector()) {
+
+      ConfigVector::iterator it = item.begin();
+      while(it!=item.end()) {
+        if(it->isAtom()) {
+          std::string value = mars::utils::trim(it->toString());
+          if(value.empty()) {
+            item.erase(it);
+            it = item.begin();
+          }
+          else {
+            ++it;
+          }
+        }
+        else if(it->isMap() || it->isVector()) {
+          trimMap(*it);
+          if(it->size() == 0) {
+            item.erase(it);
+            it = item.begin();
+          }
+          else {
+            ++it;
+          }
+        }
+        else {
+          item.erase(it);
+          it = item.begin();
+        }
+      }
+    }
+  }
+
+  // local time in ISO 8601 format
+  static std::string currentDate() {
+    char buffer[32];
+    time_t t = time(NULL);
+    strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+    return buffer;
+  }
+
+  ConfigMap CndExport::createGraphMap(ConfigMap &model, DBInterface *db,
+                                      std::vector<std::string> *errors) {
+    PhaseTimer timer("createGraphMap");
+    ConfigMap graph;
+    graph["nodes"] = ConfigVector();
+    graph["edges"] = ConfigVector();
+    if(!model.hasKey("versions") ||
+       !model["versions"][0].hasKey("components")) {
+      return graph;
+    }
+    ConfigMap &components = model["versions"][0]["components"];
+    // the first configuration of a name is used as in the gui
+    std::unordered_map<std::string, ConfigItem*> config;
+    if(components.hasKey("configuration") &&
+       components["configuration"].hasKey("nodes")) {
+      for(auto &it: components["configuration"]["nodes"]) {
+        config.insert(std::make_pair(it["name"].getString(), &it));
+      }
+    }
+    // keys of xrock_config that are moved to the node map
+    const char *xrockConfig[4] = {"activity", "state", "config_names",
+                                  "parentName"};
+    // data of the node types by domain, name and version
+    std::map<std::string, ConfigMap> types;
+    // the edges use the names of the renamed nodes
+    std::unordered_map<std::string, std::string> renamed;
+
+    if(components.hasKey("nodes")) {
+      for(auto &it: components["nodes"]) {
+        ConfigMap node;
+        std::string name = it["name"];
+        std::string domain = mars::utils::tolower(it["model"]["domain"]);
+        std::string modelName = it["model"]["name"];
+        std::string version;
+        if(it["model"].hasKey("version")) {
+          version << it["model"]["version"];
+        }
+        std::string dataKey = domain + "Data";
+        node["name"] = name;
+        node["type"] = modelName;
+        node["modelName"] = modelName;
+        node["domain"] = domain;
+        if(!version.empty()) {
+          node["modelVersion"] = version;
+        }
+        if(db && modelName != "software::Deployment") {
+          std::string key = domain + '\n' + modelName + '\n' + version;
+          std::map<std::string, ConfigMap>::iterator type = types.find(key);
+          if(type == types.end()) {
+            ConfigMap typeModel = db->requestModel(domain, modelName, version,
+                                                   !version.empty());
+            ConfigMap data;
+            if(!typeModel.hasKey("versions")) {
+              if(errors) errors->push_back("unknown type: " + modelName);
+              data["unknown"] = true;
+            }
+            else {
+              ConfigMap &typeVersion = typeModel["versions"][0];
+              if(typeVersion.hasKey(dataKey) &&
+                 typeVersion[dataKey].hasKey("data")) {
+                data["data"] = ConfigMapHelper::getData(typeVersion[dataKey]["data"]);
+              }
+              const char *defaultKeys[2] = {"defaultConfiguration", "defaultConfig"};
+              for(int i=0; i<2; ++i) {
+                if(typeVersion.hasKey(defaultKeys[i]) &&
+                   typeVersion[defaultKeys[i]].hasKey("data")) {
+                  data["defaultConfiguration"] = ConfigMapHelper::getData(typeVersion[defaultKeys[i]]["data"]);
+                  break;
+                }
+              }
+            }
+            type = types.insert(std::make_pair(key, data)).first;
+          }
+          if(type->second.hasKey("data")) {
+            node[dataKey]["data"] = type->second["data"];
+          }
+          // as Model::addNode() the default configuration is used if the
+          // type has no configuration
+          if(type->second.hasKey("defaultConfiguration") &&
+             (!node.hasKey(dataKey) || !node[dataKey]["data"].hasKey("configuration"))) {
+            node[dataKey]["data"]["configuration"] = type->second["defaultConfiguration"];
+          }
+        }
+        // Model::addNode() renames the nodes of Rock components
+        if(node.hasKey("softwareData") && node["softwareData"].hasKey("data") &&
+           node["softwareData"]["data"].hasKey("framework") &&
+           node["softwareData"]["data"]["framework"] == "Rock") {
+          std::string rockName = mars::utils::replaceString(name, ":", "_");
+          if(rockName != name) {
+            node["name"] = rockName;
+            renamed[name] = rockName;
+          }
+        }
+        std::unordered_map<std::string, ConfigItem*>::iterator conf = config.find(name);
+        if(conf != config.end()) {
+          ConfigItem &item = *(conf->second);
+          ConfigMap data;
+          if(item.hasKey("data")) {
+            data["configuration"] = ConfigMapHelper::getData(item["data"]);
+            if(data["configuration"].hasKey("xrock_config")) {
+              for(int i=0; i<4; ++i) {
+                if(data["configuration"]["xrock_config"].hasKey(xrockConfig[i])) {
+                  node[xrockConfig[i]] = data["configuration"]["xrock_config"][xrockConfig[i]];
+                }
+              }
+              ((ConfigMap&)data["configuration"]).erase("xrock_config");
+            }
+          }
+          if(item.hasKey("submodel")) {
+            ConfigMapHelper::unpackSubmodel(data, item["submodel"]);
+          }
+          if(data.size() > 0) {
+            node[dataKey]["data"].appendMap(data);
+          }
+        }
+        graph["nodes"].push_back(node);
+      }
+    }
+
+    if(components.hasKey("edges")) {
+      for(auto &it: components["edges"]) {
+        ConfigMap edge;
+        std::string fromNode = it["from"]["name"];
+        std::string toNode = it["to"]["name"];
+        std::unordered_map<std::string, std::string>::iterator name;
+        if((name = renamed.find(fromNode)) != renamed.end()) fromNode = name->second;
+        if((name = renamed.find(toNode)) != renamed.end()) toNode = name->second;
+        edge["fromNode"] = fromNode;
+        edge["fromNodeOutput"] = it["from"]["interface"];
+        edge["toNode"] = toNode;
+        edge["toNodeInput"] = it["to"]["interface"];
+        edge["name"] = it["name"];
+        if(it.hasKey("data")) {
+          edge.append(ConfigMapHelper::getData(it["data"]));
+        }
+        graph["edges"].push_back(edge);
+      }
+    }
+    return graph;
+  }
+
+  bool CndExport::exportCnd(const ConfigMap &map_,
+                             const std::string &filename, bool shutdown) {
+    PhaseTimer timer("exportCnd", true);
+    ConfigMap map = map_;
+    ConfigMap output;
+    std::set<std::string> nameMap;
+    std::map<std::string, std::string> dNameMap;
+    bool haveMarsTask = false;
+    bool compileDeployments = false;
+
+    // handle file path and node order
+    for(auto &node: map["nodes"]) {
+      if(node["type"] == "software::Deployment") {
+        std::string name = node["name"];
+
+        output["deployments"][name]["deployer"] = "orogen";
+        output["deployments"][name]["process_name"] = name;
+        output["deployments"][name]["hostID"] = "local";
+        if(node.hasKey("softwareData") and node["softwareData"].hasKey("data") and
+           node["softwareData"]["data"].hasKey("configuration")) {
+          ConfigItem item(node["softwareData"]["data"]["configuration"]);
+          trimMap(item);
+          ConfigMap m = item;
+          if(m.hasKey("deployer")) {
+            output["deployments"][name]["deployer"] = m["deployer"];
+          }
+          if(m.hasKey("process_name")) {
+            output["deployments"][name]["process_name"] = m["process_name"];
+          }
+          if(m.hasKey("hostID")) {
+            output["deployments"][name]["hostID"] = m["hostID"];
+          }
+        }
+        dNameMap[name] = output["deployments"][name]["process_name"].getString();
+      }
+      else {
+        if(node["domain"] == "software") {
+          std::string name = node["name"];
+          nameMap.insert(name);
+          ConfigItem item(node["softwareData"]["data"]);
+          trimMap(item);
+          ConfigMap m = item;
+          if(m.hasKey("properties")) {
+            ConfigVector props;
+            for(auto &prop: m["properties"]) {
+              if(prop.hasKey("Value")) {
+                props.push_back(prop);
+              }
+            }
+            m.erase("properties");
+            if(props.size() > 0) {
+              m["properties"] = props;
+            }
+          }
+          if(m.hasKey("configuration")) {
+            ConfigMap m2 = m["configuration"];
+            m.erase("configuration");
+            m.updateMap(m2);
+          }
+          if(m.hasKey("description")) {
+            m.erase("description");
+          }
+          std::string type = node["modelName"];
+          if(type == "mars::Task") {
+            haveMarsTask = true;
+          }
+          output["tasks"][name] = m;
+          output["tasks"][name]["type"] = type;
+          if(node.hasKey("parentName") and node["parentName"].getString().size() > 0) {
+            std::string parent = node["parentName"];
+            std::string process_name = defaultProcessName(node["type"]);
+            output["deployments"][parent]["taskList"][name] = process_name;
+            if(output["deployments"][parent]["taskList"].size() > 1) {
+              compileDeployments = true;
+              output["deployments"][parent]["process_name"] = dNameMap[parent];
+            }
+            else {
+              output["deployments"][parent]["process_name"] = process_name;
+            }
+          }
+          else {
+            std::string depName = name+"_deployment";
+            output["deployments"][depName]["deployer"] = "orogen";
+            output["deployments"][depName]["hostID"] = "local";
+            std::string process_name = defaultProcessName(node["type"]);
+            output["deployments"][depName]["taskList"][name] = process_name;
+            output["deployments"][depName]["process_name"] = process_name;
+            dNameMap[depName] = depName;
+          }
+        }
+      }
+    }
+    if(compileDeployments) {
+      for(ConfigMap::iterator it=output["deployments"].beginMap();
+          it!=output["deployments"].endMap(); ++it) {
+        for(ConfigMap::iterator nt=it->second["taskList"].beginMap();
+            nt!=it->second["taskList"].endMap(); ++nt) {
+          nt->second = nt->first;
+        }
+        output["deployments"][it->first]["process_name"] = dNameMap[it->first];
+      }
+    }
+    int i=0;
+    for(auto &edge: map["edges"]) {
+      ConfigMap m;
+      if(edge.hasKey("transport")) {
+        m["transport"] = edge["transport"];
+      }
+      if(edge.hasKey("type")) {
+        m["type"] = edge["type"];
+      }
+      if(edge.hasKey("size")) {
+        m["size"] = edge["size"];
+      }
+      std::string name = edge["fromNode"];
+      if(nameMap.find(name) == nameMap.end()) continue;
+      // remove domian namespace
+      m["from"]["task_id"] = name;
+      m["from"]["port_name"] = edge["fromNodeOutput"];
+      // remove domian namespace
+      name << edge["toNode"];
+      if(nameMap.find(name) == nameMap.end()) continue;
+      m["to"]["task_id"] = name;
+      m["to"]["port_name"] = edge["toNodeInput"];
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%d", i++);
+      output["connections"][std::string(buffer)] = m;
+    }
+    if(!writeYaml(output, filename)) {
+      return false;
+    }
+    if(haveMarsTask) {
+      // generate pre cnd because we have to first load mars::Task then
+      // the plugin tasks
+      for(ConfigMap::iterator it = output["tasks"].beginMap();
+          it != output["tasks"].endMap(); ++it) {
+        if(it->second["type"] != "mars::Task") {
+          it->second["state"] = "PRE_OPERATIONAL";
+        }
+      }
+      std::string preFile = filename;
+      mars::utils::removeFilenameSuffix(&preFile);
+      if(output.hasKey("connections")) {
+        output.erase("connections");
+      }
+      if(!writeYaml(output, preFile+"_pre.cnd")) {
+        return false;
+      }
+    }
+    if(shutdown) {
+      return writeShutdownCnd(mars::utils::getPathOfFile(filename));
+    }
+    return true;
+  }
+
+  bool CndExport::writeShutdownCnd(const std::string &path) {
+    std::string shutdownFile = mars::utils::pathJoin(path, "shutdown.cnd");
+    FILE *f = fopen(shutdownFile.c_str(), "w");
+    if(!f) {
+      fprintf(stderr, "ERROR: could not write %s\n", shutdownFile.c_str());
+      return false;
+    }
+    fprintf(f, "deployments:\n\ntasks:\n\nconnections:\n\n");
+    return fclose(f) == 0;
+  }
+
+  ConfigMap CndExport::importCnd(const std::string &fileName) {
+    ConfigMap map;
+    ConfigMap cnd = ConfigMap::fromYamlFile(fileName);
+    std::string name = fileName;
+    mars::utils::removeFilenamePrefix(&name);
+    mars::utils::removeFilenameSuffix(&name);
+    map["name"] = name;
+    map["domain"] = "SOFTWARE";
+    map["type"] = "CND";
+    map["versions"][0]["name"] = "v0.0.1";
+    map["versions"][0]["projectName"] = "";
+    map["versions"][0]["designedBy"] = "";
+    map["versions"][0]["date"] = currentDate();
+    map["versions"][0]["components"]["nodes"] = ConfigVector();
+    map["versions"][0]["components"]["edges"] = ConfigVector();
+    if(cnd.hasKey("tasks")) {
+      for(auto it: (ConfigMap)cnd["tasks"]) {
+        fprintf(stderr, "task name: %s\n", it.first.c_str());
+        ConfigMap node;
+        node["name"] = it.first.c_str();
+        node["model"]["domain"] = "SOFTWARE";
+        node["model"]["version"] = "v0.0.1";
+        node["model"]["name"] = it.second["type"];
+        map["versions"][0]["components"]["nodes"].push_back(node);
+        ConfigMap config;
+        config["data"] = it.second;
+        config["name"] = node["name"];
+        map["versions"][0]["components"]["configuration"]["nodes"].push_back(config);
+      }
+    }
+    return map;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,42 @@
+/**
+ * \file CndExport.hpp
+ * \brief Conversion between software graphs and cnd files
+ *
+ * The export works on the node and edge maps of the graph as returned by
+ * BagelGui::createConfigMap(). Next to the cnd file a *_pre.cnd is written
+ * if the graph contains a mars::Task and a shutdown.cnd in any case.
+ * createGraphMap() builds these maps from a model without a gui.
+ **/
+
+#ifndef XROCK_GUI_MODEL_CND_EXPORT_HPP
+#define XROCK_GUI_MODEL_CND_EXPORT_HPP
+
+#include <configmaps/ConfigMap.hpp>
+
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  class DBInterface;
+
+  class CndExport {
+  public:
+    // returns the nodes and edges of versions[0] as the gui creates them
+    // from a loaded model; the data of the node types is requested from
+    // the db, types that are not found are added to errors
+    static configmaps::ConfigMap createGraphMap(configmaps::ConfigMap &model,
+                                                DBInterface *db,
+                                                std::vector<std::string> *errors);
+    // returns false if a file could not be written; the shutdown.cnd is
+    // shared by all exports into a folder and can be written separately
+    static bool exportCnd(const configmaps::ConfigMap &map,
+                          const std::string &filename, bool shutdown=true);
+    static bool writeShutdownCnd(const std::string &path);
+    // returns a model with one software node per task of the cnd file
+    static configmaps::ConfigMap importCnd(const std::string &filename);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_CND_EXPORT_HPP
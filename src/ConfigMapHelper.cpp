@@ -4,20 +4,26 @@ using namespace configmaps;
 
 namespace xrock_gui_model {
 
-  void ConfigMapHelper::unpackSubmodel(ConfigMap &target, ConfigVector &source) {
+  void ConfigMapHelper::unpackSubmodel(ConfigMap &target, ConfigVector &source,
+                                       bool lazy) {
     size_t i = 0;
-    for(auto it: source) {
+    for(auto &it: source) {
       target["submodel"][i]["name"] = it["name"];
       if(it.hasKey("data")) {
         try {
-          target["submodel"][i]["data"] = ConfigMap::fromYamlString(it["data"]);
+          if(lazy) {
+            target["submodel"][i]["data"] = it["data"];
+          }
+          else {
+            target["submodel"][i]["data"] = getData(it["data"]);
+          }
         }
         catch (...) {
           fprintf(stderr, "ERROR: unpack submodel\n");
         }
       }
       if(it.hasKey("submodel")) {
-        unpackSubmodel(target["submodel"][i], it["submodel"]);
+        unpackSubmodel(target["submodel"][i], it["submodel"], lazy);
       }
       ++i;
     }
@@ -25,11 +31,11 @@ namespace xrock_gui_model {
 
   void ConfigMapHelper::packSubmodel(ConfigMap &target, ConfigVector &source) {
     size_t i = 0;
-    for(auto it: source) {
+    for(auto &it: source) {
       target["submodel"][i]["name"] = it["name"];
       if(it.hasKey("data")) {
         try {
-          target["submodel"][i]["data"] = it["data"].toYamlString();
+          target["submodel"][i]["data"] = it["data"];
         } catch(...) {
           fprintf(stderr, "ERROR: pack submodel\n");
         }
@@ -67,4 +73,97 @@ namespace xrock_gui_model {
     return ptr;
   }
 
+  ConfigMap ConfigMapHelper::getData(ConfigItem &data) {
+    if(data.isMap()) {
+      return data;
+    }
+    if(data.isAtom()) {
+      std::string s = data.getString();
+      if(!s.empty()) {
+        return ConfigMap::fromYamlString(s);
+      }
+    }
+    return ConfigMap();
+  }
+
+  static void convertData(ConfigItem &data, bool pack) {
+    if(pack) {
+      if(data.isMap()) {
+        std::string s = data.toYamlString();
+        data = s;
+      }
+    }
+    else if(data.isAtom()) {
+      std::string s = data.getString();
+      if(!s.empty()) {
+        try {
+          data = ConfigMap::fromYamlString(s);
+        } catch(...) {
+          fprintf(stderr, "ERROR: unpack data\n");
+        }
+      }
+    }
+  }
+
+  static void convertListData(ConfigItem &list, bool pack) {
+    if(!list.isVector()) return;
+    for(auto &it: list) {
+      if(!it.isMap()) continue;
+      if(it.hasKey("data")) {
+        convertData(it["data"], pack);
+      }
+      if(it.hasKey("submodel")) {
+        convertListData(it["submodel"], pack);
+      }
+    }
+  }
+
+  static void convertModelData(ConfigMap &model, bool pack) {
+    if(!model.hasKey("versions")) return;
+    for(auto &version: model["versions"]) {
+      if(!version.isMap()) continue;
+      ConfigMap &v = version;
+      for(auto &it: v) {
+        // <domain>Data, defaultConfiguration, and defaultConfig
+        const std::string &key = it.first;
+        if((key.size() > 4 && key.compare(key.size()-4, 4, "Data") == 0) ||
+           key == "defaultConfiguration" || key == "defaultConfig") {
+          if(it.second.isMap() && it.second.hasKey("data")) {
+            convertData(it.second["data"], pack);
+          }
+        }
+      }
+      if(v.hasKey("interfaces")) {
+        convertListData(v["interfaces"], pack);
+      }
+      if(v.hasKey("components") && v["components"].isMap()) {
+        ConfigMap &components = v["components"];
+        if(components.hasKey("configuration") &&
+           components["configuration"].hasKey("nodes")) {
+          convertListData(components["configuration"]["nodes"], pack);
+        }
+        if(components.hasKey("edges")) {
+          convertListData(components["edges"], pack);
+        }
+      }
+    }
+  }
+
+  void ConfigMapHelper::packData(ConfigMap &model) {
+    convertModelData(model, true);
+  }
+
+  void ConfigMapHelper::unpackData(ConfigMap &model) {
+    convertModelData(model, false);
+  }
+
+  void ConfigMapHelper::packEntry(ConfigMap &entry) {
+    if(entry.hasKey("data")) {
+      convertData(entry["data"], true);
+    }
+    if(entry.hasKey("submodel")) {
+      convertListData(entry["submodel"], true);
+    }
+  }
+
 } // end of namespace xrock_gui_model
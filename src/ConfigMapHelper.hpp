@@ -17,12 +17,26 @@ namespace xrock_gui_model {
     ~ConfigMapHelper() {}
 
     static void packSubmodel(configmaps::ConfigMap &target, configmaps::ConfigVector &source);
-    static void unpackSubmodel(configmaps::ConfigMap &target, configmaps::ConfigVector &source);
+    // keeps the submodel data as yaml strings if lazy is set
+    static void unpackSubmodel(configmaps::ConfigMap &target, configmaps::ConfigVector &source,
+                               bool lazy=false);
     static configmaps::ConfigItem* getSubItem(configmaps::ConfigMap &map,
                                               std::vector<std::string> path);
     static configmaps::ConfigItem* getSubItem(configmaps::ConfigItem *item,
                                               std::vector<std::string> path);
 
+    // The data fields of a model are stored as yaml strings in the
+    // databases and model files. Inside the gui they are kept as maps, the
+    // databases and the model loading unpack them once with unpackData()
+    // and packData() converts them back before storing.
+    static void packData(configmaps::ConfigMap &model);
+    static void unpackData(configmaps::ConfigMap &model);
+    // packs the data of one entry of components.configuration.nodes or
+    // components.edges
+    static void packEntry(configmaps::ConfigMap &entry);
+    // returns the data as map independent of the storage mode
+    static configmaps::ConfigMap getData(configmaps::ConfigItem &data);
+
   };
 } // end of namespace xrock_gui_model
 
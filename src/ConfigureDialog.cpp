@@ -1,4 +1,5 @@
 #include "ConfigureDialog.hpp"
+#include "PhaseTimer.hpp"
 #include <mars/config_map_gui/DataWidget.h>
 #include <mars/utils/misc.h>
 
@@ -20,6 +21,7 @@ namespace xrock_gui_model {
                                    const std::string &type, bool onlyMap,
                                    bool noTreeEdit, configmaps::ConfigMap *dropdown, std::string fileName) :
     configuration(configuration), textOnly(false)  {
+    PhaseTimer timer("ConfigureDialog::create");
 
     // get data from database
     //QVBoxLayout *vLayout = new QVBoxLayout();
@@ -170,6 +172,7 @@ namespace xrock_gui_model {
 
   ConfigureDialog::ConfigureDialog(std::string *text) :
     text(text), textOnly(true)  {
+    PhaseTimer timer("ConfigureDialog::create");
 
     configMapEdit = NULL;
     dw = NULL;
@@ -188,6 +191,7 @@ namespace xrock_gui_model {
   }
 
   ConfigureDialog::~ConfigureDialog() {
+    PhaseTimer timer("ConfigureDialog::apply");
     if(dw) {
       *configuration = dw->getConfigMap();
     }
@@ -220,6 +224,7 @@ namespace xrock_gui_model {
 
   void ConfigureDialog::timerEvent(QTimerEvent *event) {
     if(lastTextChanged != -1 && ticks-lastTextChanged > 5) {
+      PhaseTimer timer("ConfigureDialog::validate");
       try {
         ConfigMap tmpMap = ConfigMap::fromYamlString(configMapEdit->toPlainText().toStdString());
         statusLabel->setText("valid yaml syntax");
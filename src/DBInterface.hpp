@@ -9,6 +9,8 @@
 
 #include <configmaps/ConfigMap.hpp>
 
+#include <string>
+#include <vector>
 
 namespace xrock_gui_model {
 
@@ -26,8 +28,26 @@ namespace xrock_gui_model {
                                                 const bool limit = false) = 0;
     virtual bool storeModel(const configmaps::ConfigMap &map) = 0;
 
+    struct ModelRequest {
+      std::string domain, model, version;
+      bool limit;
+    };
+    // requests several models at once; the result has the order of the
+    // requests
+    virtual std::vector<configmaps::ConfigMap> requestModels(const std::vector<ModelRequest> &requests) {
+      std::vector<configmaps::ConfigMap> models;
+      for(auto &it: requests) {
+        models.push_back(requestModel(it.domain, it.model, it.version, it.limit));
+      }
+      return models;
+    }
+
     virtual void set_dbAddress(const std::string &_dbAddress) = 0;
 
+    // returns a string that changes whenever the content of the database
+    // changes; an empty string means the revision is unknown
+    virtual std::string getRevision() {return "";}
+
   };
 } // end of namespace xrock_gui_model
 
@@ -1,10 +1,14 @@
 #include "FileDB.hpp"
+#include "ConfigMapHelper.hpp"
+#include "ParallelFor.hpp"
+#include "PhaseTimer.hpp"
 #include <mars/utils/misc.h>
 #include <configmaps/ConfigVector.hpp>
 
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <sys/stat.h>
 
 using namespace configmaps;
 using namespace mars::utils;
@@ -20,6 +24,7 @@ namespace xrock_gui_model {
   }
 
   std::vector<std::pair<std::string, std::string>> FileDB::requestModelListByDomain(const std::string &domain) {
+    PhaseTimer timer("db.requestModelList");
     std::vector<std::pair<std::string, std::string>> modelList;
     if(domain != "software") return modelList;
 
@@ -34,6 +39,7 @@ namespace xrock_gui_model {
   }
 
   std::vector<std::string> FileDB::requestVersions(const std::string &domain, const std::string &model) {
+    PhaseTimer timer("db.requestVersions");
     std::vector<std::string> versionList;
     if(domain != "software") return versionList;
 
@@ -56,6 +62,7 @@ namespace xrock_gui_model {
                                  const std::string &model,
                                  const std::string &version,
                                  const bool limit) {
+    PhaseTimer timer("db.requestModel");
     std::vector<std::string> versionList;
     if(domain != "software") return ConfigMap();
     if(limit) {
@@ -66,16 +73,27 @@ namespace xrock_gui_model {
       std::string file = "info.yml";
       handleFilenamePrefix(&file, dbAddress);
       ConfigMap info = configmaps::ConfigMap::fromYamlFile(file);
-      for(auto it: info["models"]) {
-        if(it["name"] == model) {
-          for(auto it2: it["versions"]) {
-            versionList.push_back(it2["name"]);
-          }
-          break;
+      versionList = listVersions(info, model);
+    }
+    return loadVersions(model, versionList);
+  }
+
+  std::vector<std::string> FileDB::listVersions(ConfigMap &info,
+                                                const std::string &model) {
+    std::vector<std::string> versionList;
+    for(auto it: info["models"]) {
+      if(it["name"] == model) {
+        for(auto it2: it["versions"]) {
+          versionList.push_back(it2["name"]);
         }
+        break;
       }
     }
+    return versionList;
+  }
 
+  ConfigMap FileDB::loadVersions(const std::string &model,
+                                 const std::vector<std::string> &versionList) {
     bool first = true;
     ConfigMap result;
     for(auto it: versionList) {
@@ -91,12 +109,53 @@ namespace xrock_gui_model {
         result["versions"].push_back(map["versions"][0]);
       }
     }
-    
+    ConfigMapHelper::unpackData(result);
     return result;
   }
 
+  std::vector<ConfigMap> FileDB::requestModels(const std::vector<ModelRequest> &requests) {
+    PhaseTimer timer("db.requestModels");
+    std::vector<ConfigMap> models(requests.size());
+    // the index is read once for all requests without a version limit
+    ConfigMap info;
+    bool haveInfo = false;
+    std::vector<std::vector<std::string> > versionLists(requests.size());
+    for(size_t i=0; i<requests.size(); ++i) {
+      const ModelRequest &request = requests[i];
+      if(request.domain != "software") continue;
+      if(request.limit) {
+        versionLists[i].push_back(request.version);
+        continue;
+      }
+      if(!haveInfo) {
+        haveInfo = true;
+        std::string file = "info.yml";
+        handleFilenamePrefix(&file, dbAddress);
+        try {
+          info = ConfigMap::fromYamlFile(file);
+        } catch(...) {
+          fprintf(stderr, "ERROR: could not load: %s\n", file.c_str());
+        }
+      }
+      versionLists[i] = listVersions(info, request.model);
+    }
+    // a broken model file only fails its own request
+    parallelFor(requests.size(), [&](size_t i) {
+        try {
+          models[i] = loadVersions(requests[i].model, versionLists[i]);
+        } catch(...) {
+          fprintf(stderr, "ERROR: could not load model: %s\n",
+                  requests[i].model.c_str());
+          models[i] = ConfigMap();
+        }
+      });
+    return models;
+  }
+
   bool FileDB::storeModel(const ConfigMap &map_) {
+    PhaseTimer timer("db.storeModel");
     ConfigMap map = map_;
+    ConfigMapHelper::packData(map);
     std::string model = map["name"];
     std::string type = map["type"];
     std::string version = map["versions"][0]["name"];
@@ -149,5 +208,38 @@ namespace xrock_gui_model {
     dbAddress = _db_Address;
   }
 
+  static void addFileRevision(std::string &revision, const std::string &file) {
+    struct stat st;
+    char buffer[64];
+    if(stat(file.c_str(), &st) == 0) {
+      snprintf(buffer, 64, ";%lu.%09lu:%lu", (unsigned long)st.st_mtim.tv_sec,
+               (unsigned long)st.st_mtim.tv_nsec, (unsigned long)st.st_size);
+    }
+    else {
+      snprintf(buffer, 64, ";-");
+    }
+    revision += buffer;
+  }
+
+  std::string FileDB::getRevision() {
+    // the revision is build from the file stats of the index and all
+    // model files, which is much cheaper than loading the models
+    std::string file = "info.yml";
+    handleFilenamePrefix(&file, dbAddress);
+    if(!pathExists(file)) return "";
+    std::string revision = dbAddress;
+    addFileRevision(revision, file);
+    ConfigMap info = ConfigMap::fromYamlFile(file);
+    for(auto it: info["models"]) {
+      std::string model = it["name"];
+      for(auto it2: it["versions"]) {
+        std::string modelFile = model + "/" + it2["name"].getString() + "/model.yml";
+        handleFilenamePrefix(&modelFile, dbAddress);
+        addFileRevision(revision, modelFile);
+      }
+    }
+    return revision;
+  }
+
 
 } // end of namespace xrock_gui_model
@@ -25,13 +25,23 @@ namespace xrock_gui_model {
                                               const std::string &model,
                                               const std::string &version,
                                               const bool limit = false);
+    // reads the model files in parallel
+    std::vector<configmaps::ConfigMap> requestModels(const std::vector<ModelRequest> &requests);
     bool storeModel(const configmaps::ConfigMap &map);
 
     void set_dbAddress(const std::string &_dbAddress);
+    std::string getRevision();
 
   private:
     std::string dbAddress;
 
+    // returns the versions of the model listed in the index
+    static std::vector<std::string> listVersions(configmaps::ConfigMap &info,
+                                                 const std::string &model);
+    // reads and unpacks the model files of the versions
+    configmaps::ConfigMap loadVersions(const std::string &model,
+                                       const std::vector<std::string> &versionList);
+
 
   };
 } // end of namespace xrock_gui_model
@@ -1,4 +1,6 @@
 #include "ImportDialog.hpp"
+#include "ConfigMapHelper.hpp"
+#include "PhaseTimer.hpp"
 #include <mars/config_map_gui/DataWidget.h>
 
 #include <QVBoxLayout>
@@ -10,6 +12,7 @@ using namespace configmaps;
 namespace xrock_gui_model {
 
   std::string getHtml(const std::string &markdown) {
+    PhaseTimer timer("ImportDialog::getHtml");
     std::string cmd = "echo \""+ markdown + "\" | python -m markdown";
     std::array<char, 128> buffer;
     std::string result;
@@ -114,6 +117,7 @@ namespace xrock_gui_model {
   }
 
   void ImportDialog::modelClicked(const QModelIndex &index) {
+    PhaseTimer timer("ImportDialog::modelClicked");
     ignoreUpdate = true;
     std::string firstVersion;
     QVariant v = models->model()->data(index, 0);
@@ -138,6 +142,7 @@ namespace xrock_gui_model {
 
 
   void ImportDialog::versionChanged(const QString &versionName) {
+    PhaseTimer timer("ImportDialog::versionChanged");
     if(ignoreUpdate) return;
     selectedVersion = versionName.toStdString();
     dw->clearGUI();
@@ -149,7 +154,7 @@ namespace xrock_gui_model {
     doc->setHtml("");
     if(map["versions"][0].hasKey(domainData)) {
       if(map["versions"][0][domainData].hasKey("data")) {
-        ConfigMap dataMap = ConfigMap::fromYamlString(map["versions"][0][domainData]["data"]);
+        ConfigMap dataMap = ConfigMapHelper::getData(map["versions"][0][domainData]["data"]);
         if(dataMap.hasKey("description")) {
           if(dataMap["description"].hasKey("markdown")) {
             std::string md = dataMap["description"]["markdown"];
@@ -159,11 +164,13 @@ namespace xrock_gui_model {
         }
       }
     }
+    PhaseTimer dataTimer("DataWidget::setConfigMap");
     dw->setConfigMap("", map);
   }
 
 
   void ImportDialog::addModel() {
+    PhaseTimer timer("ImportDialog::addModel");
     //fprintf(stderr, "add Model: %s %s %s", selectedDomain.c_str(), selectedModel.c_str(), selectedVersion.c_str());
     if(selectedDomain  != std::string("") &&
        selectedModel   != std::string("") &&
@@ -182,6 +189,7 @@ namespace xrock_gui_model {
 
 
   void ImportDialog::updateFilter(const QString &filter) {
+    PhaseTimer timer("ImportDialog::updateFilter");
     QRegExp exp(filter);
 
     models->clear();
@@ -196,6 +204,7 @@ namespace xrock_gui_model {
 
 
   void ImportDialog::changeDomain(const QString &domain) {
+    PhaseTimer timer("ImportDialog::changeDomain");
     models->clear();
     versionSelect->clear();
     dw->clearGUI();
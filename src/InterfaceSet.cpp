@@ -0,0 +1,52 @@
+/**
+ * \file InterfaceSet.cpp
+ * \brief Collects the exported interfaces of a saved graph
+ **/
+
+#include "InterfaceSet.hpp"
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  InterfaceSet::InterfaceSet(ConfigMap &interfaceMap) : interfaceMap(interfaceMap) {
+    if(interfaceMap.hasKey("interfaces")) {
+      for(auto &it: interfaceMap["interfaces"]) {
+        names.insert(it["name"].getString());
+        keys.insert(key(it["name"], it["direction"]));
+      }
+    }
+  }
+
+  void InterfaceSet::add(ConfigMap &interface_, const std::string &name,
+                         const std::string &direction) {
+    names.insert(name);
+    keys.insert(key(name, direction));
+    interfaceMap["interfaces"].push_back(interface_);
+  }
+
+  bool InterfaceSet::addInput(ConfigMap &interface_) {
+    std::string name = interface_["name"];
+    std::string direction = interface_["direction"];
+    if(keys.count(key(name, direction))) return false;
+    add(interface_, name, direction);
+    return true;
+  }
+
+  bool InterfaceSet::addOutput(ConfigMap &interface_) {
+    std::string name = interface_["name"];
+    if(keys.count(key(name, "OUTGOING")) || keys.count(key(name, "BIDIRECTIONAL"))) {
+      return false;
+    }
+    add(interface_, name, interface_["direction"]);
+    return true;
+  }
+
+  bool InterfaceSet::addUnlinked(ConfigMap &interface_) {
+    std::string name = interface_["name"];
+    if(names.count(name)) return false;
+    add(interface_, name, interface_["direction"]);
+    return true;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,45 @@
+/**
+ * \file InterfaceSet.hpp
+ * \brief Collects the exported interfaces of a saved graph
+ *
+ * Used by ModelWidget::saveGraph() and the benchmark. Inputs are unique
+ * by name and direction, an output is dropped if an outgoing or
+ * bidirectional interface of the same name exists, and interfaces not
+ * linked to a node are unique by name.
+ **/
+
+#ifndef XROCK_GUI_MODEL_INTERFACE_SET_HPP
+#define XROCK_GUI_MODEL_INTERFACE_SET_HPP
+
+#include <configmaps/ConfigMap.hpp>
+
+#include <string>
+#include <unordered_set>
+
+namespace xrock_gui_model {
+
+  class InterfaceSet {
+  public:
+    // the interfaces are appended to interfaceMap["interfaces"], the
+    // entries already in the list are kept
+    explicit InterfaceSet(configmaps::ConfigMap &interfaceMap);
+
+    // return true if the interface was added
+    bool addInput(configmaps::ConfigMap &interface_);
+    bool addOutput(configmaps::ConfigMap &interface_);
+    bool addUnlinked(configmaps::ConfigMap &interface_);
+
+  private:
+    configmaps::ConfigMap &interfaceMap;
+    std::unordered_set<std::string> names, keys;
+
+    static std::string key(const std::string &name, const std::string &direction) {
+      return name + '\n' + direction;
+    }
+    void add(configmaps::ConfigMap &interface_, const std::string &name,
+             const std::string &direction);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_INTERFACE_SET_HPP
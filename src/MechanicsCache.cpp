@@ -0,0 +1,135 @@
+/**
+ * \file MechanicsCache.cpp
+ * \brief Expanded mechanics hierarchies for the import into bagel
+ **/
+
+#include "MechanicsCache.hpp"
+#include "ConfigMapHelper.hpp"
+#include "DBInterface.hpp"
+#include "PhaseTimer.hpp"
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  // the yaml strings of the components and the mechanics data, maps are
+  // serialized
+  static std::string itemKey(ConfigItem &item) {
+    if(item.isAtom()) return item.getString();
+    return item.toYamlString();
+  }
+
+  static std::string contentKey(ConfigMap &model) {
+    std::string key;
+    if(!model.hasKey("versions") || model["versions"].size() == 0) {
+      return key;
+    }
+    ConfigMap &version = model["versions"][0];
+    if(version.hasKey("components")) {
+      key = itemKey(version["components"]);
+    }
+    key += "\n---\n";
+    if(version.hasKey("mechanicsData") &&
+       version["mechanicsData"].hasKey("data")) {
+      key += itemKey(version["mechanicsData"]["data"]);
+    }
+    return key;
+  }
+
+  std::shared_ptr<const MechanicsCache::Expansion> MechanicsCache::expand(ConfigMap &model) {
+    PhaseTimer timer("mechanics.expand");
+    // expand() runs once per import, so the revision is checked once per
+    // import; the expansions contain the submodels of the db, thus both
+    // memos are dropped once it changed; without a revision they are only
+    // shared within one expansion
+    std::string current = db ? db->getRevision() : "";
+    if(current.empty() || current != revision ||
+       byContent.size() > maxExpansions) {
+      byContent.clear();
+      byName.clear();
+      revision = current;
+    }
+    return expandModel(model);
+  }
+
+  void MechanicsCache::clear() {
+    byContent.clear();
+    byName.clear();
+    revision.clear();
+  }
+
+  std::shared_ptr<const MechanicsCache::Expansion> MechanicsCache::expandModel(ConfigMap &model) {
+    std::string key = contentKey(model);
+    auto it = byContent.find(key);
+    if(it != byContent.end()) {
+      if(!it->second) {
+        fprintf(stderr, "ERROR: mechanics model %s contains itself\n",
+                model["name"].getString().c_str());
+        return std::make_shared<const Expansion>();
+      }
+      return it->second;
+    }
+    // marks the expansion in progress to stop on cyclic models; the mark
+    // is removed if the expansion fails
+    struct InProgress {
+      std::unordered_map<std::string, std::shared_ptr<const Expansion> > &map;
+      const std::string &key;
+      bool done;
+      InProgress(std::unordered_map<std::string, std::shared_ptr<const Expansion> > &map,
+                 const std::string &key) : map(map), key(key), done(false) {
+        map[key] = NULL;
+      }
+      ~InProgress() {
+        if(!done) map.erase(key);
+      }
+    } inProgress(byContent, key);
+    std::shared_ptr<Expansion> expansion = std::make_shared<Expansion>();
+    if(model.hasKey("versions") && model["versions"].size() > 0) {
+      ConfigMap &version = model["versions"][0];
+      ConfigMap components;
+      if(version.hasKey("components")) {
+        components = ConfigMapHelper::getData(version["components"]);
+      }
+      if(components.hasKey("nodes")) {
+        for(auto &node: components["nodes"]) {
+          if(node["model"]["domain"] != "mechanics") continue;
+          Expansion::Item item;
+          item.name = node["name"].getString();
+          std::string modelName = node["model"]["name"];
+          if(modelName == "motor_universal") {
+            expansion->motors.push_back(item.name);
+          }
+          else {
+            item.submodel = expandSubmodel(modelName);
+          }
+          expansion->items.push_back(item);
+        }
+      }
+      if(version.hasKey("mechanicsData") &&
+         version["mechanicsData"].hasKey("data")) {
+        ConfigMap data = ConfigMapHelper::getData(version["mechanicsData"]["data"]);
+        if(data.hasKey("bagel_control")) {
+          expansion->bagelControl = data["bagel_control"].getString();
+        }
+      }
+    }
+    byContent[key] = expansion;
+    inProgress.done = true;
+    return expansion;
+  }
+
+  std::shared_ptr<const MechanicsCache::Expansion> MechanicsCache::expandSubmodel(const std::string &name) {
+    auto it = byName.find(name);
+    if(it != byName.end()) {
+      return it->second;
+    }
+    ConfigMap model;
+    if(db) {
+      model = db->requestModel("mechanics", name, std::string("v1"));
+    }
+    std::shared_ptr<const Expansion> expansion = expandModel(model);
+    byName[name] = expansion;
+    return expansion;
+  }
+
+} // end of namespace xrock_gui_model
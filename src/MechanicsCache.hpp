@@ -0,0 +1,71 @@
+/**
+ * \file MechanicsCache.hpp
+ * \brief Expanded mechanics hierarchies for the import into bagel
+ *
+ * A mechanics model is expanded into its motors, its bagel control and
+ * its sub-assemblies. Expansions are keyed by the content of the model,
+ * so a sub-assembly used several times is parsed once and the memo stays
+ * valid between imports. The memo and the submodels requested from the
+ * db are kept as long as the revision of the db does not change.
+ **/
+
+#ifndef XROCK_GUI_MODEL_MECHANICS_CACHE_HPP
+#define XROCK_GUI_MODEL_MECHANICS_CACHE_HPP
+
+#include <configmaps/ConfigMap.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  class DBInterface;
+
+  class MechanicsCache {
+  public:
+    struct Expansion {
+      struct Item {
+        // node name relative to the parent
+        std::string name;
+        // the expanded sub-assembly, a motor if not set
+        std::shared_ptr<const Expansion> submodel;
+      };
+      std::vector<Item> items;
+      // graph file of the bagel control of this level, may be empty
+      std::string bagelControl;
+      // names of the motors of this level in model order
+      std::vector<std::string> motors;
+    };
+
+    explicit MechanicsCache(DBInterface *db = NULL) : db(db) {}
+
+    void setDB(DBInterface *db_) {
+      db = db_;
+      clear();
+    }
+
+    std::shared_ptr<const Expansion> expand(configmaps::ConfigMap &model);
+    void clear();
+    // returns the node name of a child in the flat bagel graph
+    static std::string childPath(const std::string &path,
+                                 const std::string &name) {
+      return path.empty() ? name : path + "_" + name;
+    }
+
+  private:
+    // the memo is dropped when it grows beyond this number of models
+    static const size_t maxExpansions = 1000;
+    DBInterface *db;
+    std::string revision;
+    std::unordered_map<std::string, std::shared_ptr<const Expansion> > byContent;
+    std::unordered_map<std::string, std::shared_ptr<const Expansion> > byName;
+
+    std::shared_ptr<const Expansion> expandModel(configmaps::ConfigMap &model);
+    std::shared_ptr<const Expansion> expandSubmodel(const std::string &name);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_MECHANICS_CACHE_HPP
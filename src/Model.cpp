@@ -5,12 +5,20 @@
 
 #include "Model.hpp"
 #include "ConfigMapHelper.hpp"
+#include "NodeInfoLoader.hpp"
+#include "DBInterface.hpp"
+#include "PhaseTimer.hpp"
 #include <osg_graph_viz/Node.hpp>
 #include <bagel_gui/BagelGui.hpp>
 #include <QMessageBox>
 
 #include <mars/utils/misc.h>
-#include <dirent.h>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 using namespace bagel_gui;
 using namespace configmaps;
@@ -18,7 +26,106 @@ using namespace mars::utils;
 
 namespace xrock_gui_model {
 
-  Model::Model(BagelGui *bagelGui) : ModelInterface(bagelGui) {
+  static const StringId softwareId = internString("software");
+  static const StringId assemblyId = internString("assembly");
+
+  // The database is read by a background thread while the node infos are
+  // build by the gui thread, the string table and addNodeInfo() are not
+  // thread safe.
+  struct Model::DBBootstrap {
+    DBBootstrap() : next(0), hit(false), listed(false), done(false),
+                    cancel(false) {}
+    ~DBBootstrap() {stop();}
+
+    Model *owner;
+    DBInterface *db;
+    // the catalog cache of the owner, it is kept until the thread is joined
+    NodeInfoCatalogCache *cache;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::string revision;
+    // the models in list order, the ones not requested yet, the requested
+    // ones the gui waits for, and the one currently requested
+    std::vector<std::string> names;
+    size_t next;
+    std::unordered_set<std::string> pending;
+    std::deque<std::string> priority;
+    std::string loading;
+    std::deque<ConfigMap> ready;
+    NodeInfoMap cachedInfos;
+    bool hit, listed, done, cancel;
+    // all infos for the catalog cache, only used by the gui thread
+    NodeInfoMap infos;
+
+    void run();
+    void stop() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancel = true;
+      }
+      if(thread.joinable()) thread.join();
+    }
+  };
+
+  std::set<Model*> Model::liveModels;
+  std::unique_ptr<Model::DBBootstrap> Model::dbBootstrap;
+
+  void Model::DBBootstrap::run() {
+    PhaseTimer timer("catalog.load");
+    std::string rev = db->getRevision();
+    NodeInfoMap cached;
+    bool cacheHit = (!rev.empty() && cache && cache->get("db", rev, cached));
+    std::vector<std::pair<std::string, std::string>> models;
+    if(!cacheHit) {
+      models = db->requestModelListByDomain("software");
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      revision = rev;
+      hit = cacheHit;
+      cachedInfos.swap(cached);
+      for(auto &it: models) {
+        if(pending.insert(it.first).second) names.push_back(it.first);
+      }
+      listed = true;
+    }
+    changed.notify_all();
+    while(true) {
+      std::string name;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        // the types the gui waits for are requested first
+        while(name.empty() && !priority.empty()) {
+          if(pending.count(priority.front())) name = priority.front();
+          priority.pop_front();
+        }
+        while(name.empty() && next < names.size()) {
+          if(pending.count(names[next])) name = names[next];
+          ++next;
+        }
+        if(cancel || name.empty()) break;
+        pending.erase(name);
+        loading = name;
+      }
+      ConfigMap model = db->requestModel("software", name, "");
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(ConfigMap());
+        ready.back().swap(model);
+        loading.clear();
+      }
+      changed.notify_all();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+    }
+    changed.notify_all();
+  }
+
+  Model::Model(BagelGui *bagelGui) : ModelInterface(bagelGui),
+                                     catalog(new NodeInfoCatalog()) {
     std::string confDir = bagelGui->getConfigDir();
     ConfigMap config = ConfigMap::fromYamlFile(confDir+"/config_default.yml", true);
     if(mars::utils::pathExists(confDir+"/config.yml")) {
@@ -36,10 +143,16 @@ namespace xrock_gui_model {
       }
     }
 
+    NodeInfoLoader loader;
+    std::string catalogCacheFile = confDir + "/node_info_catalog.bin";
+    if(config.hasKey("NodeInfoCatalogCache")) {
+      catalogCacheFile << config["NodeInfoCatalogCache"];
+    }
+    catalogCache.reset(new NodeInfoCatalogCache(catalogCacheFile));
     {
       std::vector<std::string>::iterator it = searchPaths.begin();
       for(; it!=searchPaths.end(); ++it) {
-        loadNodeInfo(*it);
+        loadNodeInfo(loader, *it);
       }
     }
 
@@ -52,7 +165,7 @@ namespace xrock_gui_model {
     info.map["font_size"] = 28.;
     info.type = "DES";
     info.map["NodeClass"] = "GUINode";
-    infoMap[info.type] = info;
+    editNodeInfos()[info.type] = info;
     // info.map["NodeClass"] = "Rock";
     // info.map["type"] = "software::Deployment";
     // info.map["modelName"] = "Deployment";
@@ -72,17 +185,31 @@ namespace xrock_gui_model {
         }
       }
       orogenFolder += (std::string)config["OrogenFolder"];
-      loadNodeInfo(orogenFolder, true);
+      loadNodeInfo(loader, orogenFolder, true);
     }
-    edition = "";
+    edition = 0;
+    dirty = false;
+    changes = 0;
+    liveModels.insert(this);
   }
 
-  Model::Model(const Model *other) : ModelInterface(other->bagelGui) {
-    infoMap = other->infoMap;
-    edition = "";
+  Model::Model(const Model *other) : ModelInterface(other->bagelGui),
+                                     catalog(other->catalog) {
+    edition = 0;
+    dirty = false;
+    changes = 0;
+    liveModels.insert(this);
   }
 
   Model::~Model() {
+    liveModels.erase(this);
+    if(dbBootstrap && dbBootstrap->owner == this) {
+      dbBootstrap->stop();
+      dbBootstrap.reset();
+    }
+    if(catalogCache) {
+      catalogCache->save();
+    }
   }
 
   ModelInterface* Model::clone() {
@@ -91,45 +218,173 @@ namespace xrock_gui_model {
     return newModel;
   }
 
+  NodeInfoMap& Model::editNodeInfos() {
+    if(catalog.use_count() > 1) {
+      catalog = std::make_shared<NodeInfoCatalog>(*catalog);
+    }
+    ++catalog->revision;
+    return catalog->infos;
+  }
+
   void Model::setEdition(const std::string v) {
-    edition = tolower(v);
-  }
-
-  void Model::loadNodeInfo(std::string path, bool orogen) {
-    if(path[path.size()-1] != '/') {
-      path += "/";
-    }
-    DIR *dir;
-    struct dirent *ent;
-    if ((dir = opendir (path.c_str())) != NULL) {
-      // go through all entities
-      while ((ent = readdir (dir)) != NULL) {
-        std::string file = ent->d_name;
-
-        if (file.find(".yml", file.size() - 4, 4) != std::string::npos) {
-          // try to load the yaml-file
-          //fprintf(stderr, "load: %s\n", file.c_str());
-          ConfigMap map = ConfigMap::fromYamlFile(path + file);
-          if(orogen) {
-            addOrogenInfo(map);
-          }
-          else {
-            addNodeInfo(map);
-          }
-        } else if (file.find(".", 0, 1) != std::string::npos) {
-          // skip ".*"
-        } else {
-          // go into the next dir
-          loadNodeInfo(path + file + "/", orogen);
+    edition = StringTable::global().lower(internString(v));
+  }
+
+  void Model::loadNodeInfo(NodeInfoLoader &loader, std::string path,
+                           bool orogen) {
+    std::vector<NodeInfoLoader::FileEntry> files = loader.listFiles(path);
+    std::vector<NodeInfoMap> infos(files.size());
+    std::vector<NodeInfoLoader::FileEntry> changed;
+    std::vector<size_t> changedIndex;
+    std::string prefix = orogen ? "orogen:" : "file:";
+    for(size_t i=0; i<files.size(); ++i) {
+      if(!catalogCache ||
+         !catalogCache->get(prefix + files[i].path, files[i].fingerprint(),
+                            infos[i])) {
+        changed.push_back(files[i]);
+        changedIndex.push_back(i);
+      }
+    }
+    // the files are parsed in parallel
+    std::vector<ConfigMap> maps = loader.load(changed);
+    for(size_t i=0; i<changed.size(); ++i) {
+      NodeInfoMap &target = infos[changedIndex[i]];
+      target = buildNodeInfos(maps[i], orogen);
+      if(catalogCache) {
+        catalogCache->set(prefix + changed[i].path, changed[i].fingerprint(),
+                          target);
+      }
+    }
+    // merge in directory order to keep the first definition of a type
+    for(auto &it: infos) {
+      mergeNodeInfos(it);
+    }
+  }
+
+  void Model::startDBNodeInfos(DBInterface *db) {
+    if(dbBootstrap) return;
+    dbBootstrap.reset(new DBBootstrap());
+    DBBootstrap *b = dbBootstrap.get();
+    b->owner = this;
+    b->db = db;
+    b->cache = catalogCache.get();
+    b->thread = std::thread([b]() {b->run();});
+  }
+
+  bool Model::pollDBNodeInfos(size_t maxModels) {
+    if(!dbBootstrap) return false;
+    PhaseTimer timer("catalog.poll");
+    DBBootstrap &b = *dbBootstrap;
+    std::vector<ConfigMap> models;
+    NodeInfoMap infos;
+    bool finished;
+    {
+      std::lock_guard<std::mutex> lock(b.mutex);
+      while(!b.ready.empty() && models.size() < maxModels) {
+        models.push_back(ConfigMap());
+        models.back().swap(b.ready.front());
+        b.ready.pop_front();
+      }
+      infos.swap(b.cachedInfos);
+      finished = b.done && b.ready.empty();
+    }
+    for(auto &it: models) {
+      NodeInfoMap modelInfos = b.owner->buildNodeInfos(it, false);
+      // keep the first model of a type
+      infos.insert(modelInfos.begin(), modelInfos.end());
+    }
+    if(!b.hit) {
+      b.infos.insert(infos.begin(), infos.end());
+    }
+    unsigned long revision = b.owner->getNodeInfoRevision();
+    b.owner->publishNodeInfos(infos);
+    bool changed = b.owner->getNodeInfoRevision() != revision;
+    if(finished) {
+      if(b.thread.joinable()) b.thread.join();
+      std::unique_ptr<NodeInfoCatalogCache> &cache = b.owner->catalogCache;
+      if(cache) {
+        // an incomplete catalog is not cached
+        if(!b.hit && !b.cancel && !b.revision.empty()) {
+          cache->set("db", b.revision, b.infos);
         }
+        cache->save();
+        cache.reset();
+      }
+      dbBootstrap.reset();
+    }
+    return changed;
+  }
+
+  bool Model::waitForDBNodeInfos(const std::vector<std::string> &types) {
+    if(!dbBootstrap || types.empty()) return false;
+    PhaseTimer timer("catalog.wait");
+    DBBootstrap &b = *dbBootstrap;
+    {
+      std::unique_lock<std::mutex> lock(b.mutex);
+      b.changed.wait(lock, [&b]() {return b.listed || b.done;});
+      for(auto &it: types) {
+        if(b.pending.count(it)) b.priority.push_back(it);
+      }
+      b.changed.wait(lock, [&b, &types]() {
+          if(b.done) return true;
+          for(auto &it: types) {
+            if(b.pending.count(it) || b.loading == it) return false;
+          }
+          return true;
+        });
+    }
+    return pollDBNodeInfos(std::numeric_limits<size_t>::max());
+  }
+
+  bool Model::cancelDBNodeInfos() {
+    if(!dbBootstrap) return false;
+    dbBootstrap->stop();
+    return pollDBNodeInfos(std::numeric_limits<size_t>::max());
+  }
+
+  void Model::stopDBNodeInfos() {
+    if(!dbBootstrap) return;
+    dbBootstrap->stop();
+    dbBootstrap.reset();
+  }
+
+  NodeInfoMap Model::buildNodeInfos(ConfigMap &model, bool orogen) {
+    std::shared_ptr<NodeInfoCatalog> current = catalog;
+    catalog = std::make_shared<NodeInfoCatalog>();
+    if(orogen) {
+      addOrogenInfo(model);
+    }
+    else {
+      addNodeInfo(model);
+    }
+    NodeInfoMap infos;
+    infos.swap(catalog->infos);
+    catalog = current;
+    return infos;
+  }
+
+  void Model::mergeNodeInfos(const NodeInfoMap &infos) {
+    NodeInfoMap *target = NULL;
+    for(auto &it: infos) {
+      if(nodeInfos().find(it.first) != nodeInfos().end()) continue;
+      if(!target) target = &editNodeInfos();
+      (*target)[it.first] = it.second;
+    }
+  }
+
+  void Model::publishNodeInfos(const NodeInfoMap &infos) {
+    if(infos.empty()) return;
+    std::shared_ptr<NodeInfoCatalog> before = catalog;
+    mergeNodeInfos(infos);
+    for(Model *model: liveModels) {
+      if(model == this) continue;
+      if(model->catalog == before) {
+        model->catalog = catalog;
+      }
+      else {
+        model->mergeNodeInfos(infos);
       }
-      closedir (dir);
-    } else {
-      // this is not a directory
-      fprintf(stderr, "Specified path '%s' is not a valid directory\n",
-              path.c_str());
     }
-    return;
   }
 
   bool Model::addNodeInfo(ConfigMap &model, std::string version) {
@@ -139,8 +394,8 @@ namespace xrock_gui_model {
     int numInputs = 0;
     int numOutputs = 0;
     int versionIndex = 0;
-    std::string domain = model["domain"];
-    domain = tolower(domain);
+    StringTable &strings = StringTable::global();
+    std::string domain = strings.tolower(model["domain"]);
     std::string type = model["name"];
 
     if(!version.empty()) {
@@ -157,7 +412,7 @@ namespace xrock_gui_model {
                 version.c_str(), type.c_str());
         return false;
       }
-      if(infoMap.find(type) != infoMap.end()) {
+      if(nodeInfos().find(type) != nodeInfos().end()) {
         type += "::" + version;
       }
     }
@@ -165,7 +420,7 @@ namespace xrock_gui_model {
       version << model["versions"][versionIndex]["name"];
     }
 
-    if(infoMap.find(type) != infoMap.end()) return false;
+    if(nodeInfos().find(type) != nodeInfos().end()) return false;
     //fprintf(stderr, "map:\n%s\n", map.toYamlString().c_str());
     ConfigMap map, tmpMap;
     {
@@ -180,16 +435,7 @@ namespace xrock_gui_model {
           iDomain << (*it)["domain"];
         }
         if(it->hasKey("data")) {
-          ConfigMap dataMap;
-          if((*it)["data"].isMap()) {
-            dataMap = (*it)["data"];
-          }
-          else {
-            std::string dataString = (*it)["data"];
-            if(!dataString.empty()) {
-              dataMap = ConfigMap::fromYamlString(dataString);
-            }
-          }
+          ConfigMap dataMap = ConfigMapHelper::getData((*it)["data"]);
           if(dataMap.hasKey("domain")) {
             iDomain << dataMap["domain"];
           }
@@ -200,7 +446,7 @@ namespace xrock_gui_model {
           interface_["type"] = (*it)["type"];
           interface_["direction"] = "incoming";
           if(!iDomain.empty()) {
-            interface_["domain"] = tolower(iDomain);
+            interface_["domain"] = strings.tolower(iDomain);
           }
           tmpMap["inputs"].push_back(interface_);
           ++numInputs;
@@ -211,7 +457,7 @@ namespace xrock_gui_model {
           interface_["type"] = (*it)["type"];
           interface_["direction"] = "outgoing";
           if(!iDomain.empty()) {
-            interface_["domain"] = tolower(iDomain);
+            interface_["domain"] = strings.tolower(iDomain);
           }
           tmpMap["outputs"].push_back(interface_);
           ++numOutputs;
@@ -222,7 +468,7 @@ namespace xrock_gui_model {
           interface_["type"] = (*it)["type"];
           interface_["direction"] = "bidirectional";
           if(!iDomain.empty()) {
-            interface_["domain"] = tolower(iDomain);
+            interface_["domain"] = strings.tolower(iDomain);
           }
           map["inputs"].push_back(interface_);
           map["outputs"].push_back(interface_);
@@ -248,29 +494,34 @@ namespace xrock_gui_model {
     if(!version.empty()) {
       info.map["modelVersion"] = version;
     }
+    // the data strings are kept and only parsed when a node of this type
+    // is created (see expandData())
+    bool hasSubmodel = (model["versions"][versionIndex].hasKey("components") &&
+                        model["versions"][versionIndex]["components"].hasKey("configuration") &&
+                        model["versions"][versionIndex]["components"]["configuration"].hasKey("nodes"));
     if(model["versions"][versionIndex].hasKey(domain+"Data")) {
       if(model["versions"][versionIndex][domain+"Data"].hasKey("data")) {
         info.map[domain+"Data"]= model["versions"][versionIndex][domain+"Data"];
-        // unpack the data string for the gui
-        info.map[domain+"Data"]["data"] = ConfigMap::fromYamlString(model["versions"][versionIndex][domain+"Data"]["data"]);
+        if(hasSubmodel) {
+          // the submodel is merged into the data
+          info.map[domain+"Data"]["data"] = ConfigMapHelper::getData(model["versions"][versionIndex][domain+"Data"]["data"]);
+        }
       }
     }
     if(model["versions"][versionIndex].hasKey("defaultConfiguration") &&
        model["versions"][versionIndex]["defaultConfiguration"].hasKey("data")) {
-      info.map["defaultConfiguration"]["data"] = ConfigMap::fromYamlString(model["versions"][versionIndex]["defaultConfiguration"]["data"]);
+      info.map["defaultConfiguration"]["data"] = model["versions"][versionIndex]["defaultConfiguration"]["data"];
     }
     else if(model["versions"][versionIndex].hasKey("defaultConfig") &&
        model["versions"][versionIndex]["defaultConfig"].hasKey("data")) {
-      info.map["defaultConfiguration"]["data"] = ConfigMap::fromYamlString(model["versions"][versionIndex]["defaultConfig"]["data"]);
+      info.map["defaultConfiguration"]["data"] = model["versions"][versionIndex]["defaultConfig"]["data"];
     }
-    if(model["versions"][versionIndex].hasKey("components") &&
-       model["versions"][versionIndex]["components"].hasKey("configuration") &&
-       model["versions"][versionIndex]["components"]["configuration"].hasKey("nodes")) {
-      ConfigMapHelper::unpackSubmodel(info.map[domain+"Data"]["data"], model["versions"][versionIndex]["components"]["configuration"]["nodes"]);
+    if(hasSubmodel) {
+      ConfigMapHelper::unpackSubmodel(info.map[domain+"Data"]["data"], model["versions"][versionIndex]["components"]["configuration"]["nodes"], true);
     }
     info.type = type;
     info.map["NodeClass"] = "xrock";
-    infoMap[info.type] = info;
+    editNodeInfos()[info.type] = info;
 
     return true;
   }
@@ -285,7 +536,7 @@ namespace xrock_gui_model {
       for(auto it2: (ConfigMap)it.second) {
         std::string name = libName + "::" + it2.first;
         std::string type = "software::" + name;
-        if(infoMap.find(type) != infoMap.end()) continue;
+        if(nodeInfos().find(type) != nodeInfos().end()) continue;
         ConfigMap map;
         map["modelVersion"] = "v0.1";
         map["modelName"] = name;
@@ -319,7 +570,7 @@ namespace xrock_gui_model {
         info.numInputs = numInputs;
         info.numOutputs = numOutputs;
         info.map = map;
-        infoMap[type] = info;
+        editNodeInfos()[type] = info;
       }
     }
 
@@ -332,7 +583,8 @@ namespace xrock_gui_model {
     std::string nodeType = map["type"];
     std::string nodeName = map["name"];
     if(nodeType == "DES") return true;
-    if(nodeMap.find(nodeId) == nodeMap.end()) {
+    if(!graph.getNode(nodeId)) {
+      expandData(map);
       if(map.hasKey("defaultConfiguration")) {
         std::string domainData = map["domain"];
         domainData += "Data";
@@ -348,8 +600,9 @@ namespace xrock_gui_model {
           map["name"] = mars::utils::replaceString(nodeName, ":", "_");
         }
       }
-      nodeMap[nodeId] = map;
-      return true;
+      bool added = graph.addNode(nodeId, map);
+      setChanged(added);
+      return added;
     }
     return false;
   }
@@ -363,65 +616,56 @@ namespace xrock_gui_model {
   bool Model::addEdge(unsigned long edgeId, configmaps::ConfigMap *edge) {
     ConfigMap &map = *edge;
 
-    if(edgeMap.find(edgeId) != edgeMap.end()) return false;
+    if(graph.getEdge(edgeId)) return false;
 
     // todo: add error handling
-    std::string fromNode = map["fromNode"];
     std::string fromNodePort = map["fromNodeOutput"];
-    std::string toNode = map["toNode"];
     std::string toNodePort = map["toNodeInput"];
-    std::string fromDomain;
-    std::string toDomain;
-    ConfigMap fromNodeMap;
-    for(auto node: nodeMap) {
-      if(node.second["name"] == fromNode) {
-        fromDomain << node.second["domain"];
-        fromNodeMap = node.second;
-        if(node.second["domain"] == "software") {
-          // todo: add framework handling
-          if(node.second["xrock_type"] == "system_modelling::task_graph::Task") {
+    StringId fromDomain = 0;
+    StringId toDomain = 0;
+    const ModelGraph::Node *fromNode = graph.findNode(map["fromNode"]);
+    const ModelGraph::Node *toNode = graph.findNode(map["toNode"]);
+    if(fromNode) {
+      fromDomain = fromNode->domain;
+      if(fromDomain == softwareId) {
+        // todo: add framework handling
+        const std::string &xrockType = graph.str(fromNode->xrockType);
+        if(xrockType == "system_modelling::task_graph::Task") {
+          if(!map.hasKey("transport")) {
+            map["transport"] = "CORBA";
+            map["type"] = "DATA";
+            map["size"] = "100";
+          }
+        }
+        else if(matchPattern("bagel::*", xrockType)) {
+          if(!map.hasKey("weight")) {
+            map["weight"] = "1.0";
+          }
+        }
+      }
+      if(fromDomain == assemblyId) {
+        const ModelGraph::Port *port = graph.findOutput(*fromNode, fromNodePort);
+        if(port) {
+          fromDomain = port->domain;
+          // currently we can't decide wether the software interface of the assembly is from a Rock or
+          // other framework
+          if(fromDomain == softwareId) {
             if(!map.hasKey("transport")) {
               map["transport"] = "CORBA";
               map["type"] = "DATA";
               map["size"] = "100";
             }
           }
-          else if(matchPattern("bagel::*", node.second["xrock_type"])) {
-            if(!map.hasKey("weight")) {
-              map["weight"] = "1.0";
-            }
-          }
         }
-        if(fromDomain == "assembly") {
-          for(auto it: node.second["outputs"]) {
-            if(it["name"] == fromNodePort) {
-              fromDomain << it["domain"];
-              // currently we can't decide wether the software interface of the assembly is from a Rock or
-              // other framework
-              if(fromDomain == "software") {
-                if(!map.hasKey("transport")) {
-                  map["transport"] = "CORBA";
-                  map["type"] = "DATA";
-                  map["size"] = "100";
-                }
-              }
-              break;
-            }
-          }
-        }
-        if(!toDomain.empty()) break;
-      }
-      if(node.second["name"] == toNode) {
-        toDomain << node.second["domain"];
-        if(toDomain == "assembly") {
-          for(auto it: node.second["inputs"]) {
-            if(it["name"] == toNodePort) {
-              toDomain << it["domain"];
-              break;
-            }
-          }
+      }
+    }
+    if(toNode) {
+      toDomain = toNode->domain;
+      if(toDomain == assemblyId) {
+        const ModelGraph::Port *port = graph.findInput(*toNode, toNodePort);
+        if(port) {
+          toDomain = port->domain;
         }
-        if(!fromDomain.empty()) break;
       }
     }
 
@@ -430,19 +674,16 @@ namespace xrock_gui_model {
     if(fromDomain != toDomain) {
       return false;
     }
-    if(fromDomain == "assembly") {
-      for(auto it: fromNodeMap["outputs"]) {
-        if((std::string)it["name"] == fromNodePort) {
-          map["domain"] = it["domain"];
-          break;
-        }
+    map["domain"] = graph.str(fromDomain);
+    if(fromDomain == assemblyId && fromNode) {
+      const ModelGraph::Port *port = graph.findOutput(*fromNode, fromNodePort);
+      if(port) {
+        map["domain"] = graph.str(port->domain);
       }
     }
-    else {
-      map["domain"] << fromDomain;
-    }
-    edgeMap[edgeId] = map;
-    return true;
+    bool added = graph.addEdge(edgeId, map);
+    setChanged(added);
+    return added;
   }
 
   bool Model::addEdge(unsigned long edgeId,
@@ -451,20 +692,20 @@ namespace xrock_gui_model {
     return addEdge(edgeId, &map);
   }
 
+  bool Model::updateEdge(unsigned long edgeId,
+                         configmaps::ConfigMap edge) {
+    setChanged(graph.updateEdge(edgeId, edge));
+    return true;
+  }
+
   bool Model::hasEdge(configmaps::ConfigMap *edge) {
     ConfigMap &map = *edge;
-
-    for (auto it=edgeMap.begin(); it!=edgeMap.end(); ++it) {
-      if (it->second["fromNode"]       == map["fromNode"]       &&
-          it->second["toNode"]         == map["toNode"]         &&
-          it->second["fromNodeOutput"] == map["fromNodeOutput"] &&
-          it->second["toNodeInput"]    == map["toNodeInput"]
-         )
-      {
-        return true;
-      }
+    if(!map.hasKey("fromNode") || !map.hasKey("fromNodeOutput") ||
+       !map.hasKey("toNode") || !map.hasKey("toNodeInput")) {
+      return false;
     }
-    return false;
+    return graph.hasEdge(map["fromNode"], map["fromNodeOutput"],
+                         map["toNode"], map["toNodeInput"]);
   }
 
   bool Model::hasEdge(const configmaps::ConfigMap &edge) {
@@ -474,75 +715,79 @@ namespace xrock_gui_model {
 
   bool Model::groupNodes(unsigned long groupNodeId, unsigned long nodeId) {
     // todo: handle deployments
-    std::map<unsigned long, ConfigMap>::iterator it = nodeMap.find(groupNodeId);
-    if(it != nodeMap.end()) {
-      if((std::string)it->second["type"] == "software::Deployment") {
+    const ModelGraph::Node *node = graph.getNode(groupNodeId);
+    if(node) {
+      if(graph.str(node->type) == "software::Deployment") {
         return true;
       }
     }
     return false;
   }
 
+  std::vector<ConfigMap> Model::getEdgesOfNode(const std::string &nodeName) {
+    std::vector<ConfigMap> edges;
+    std::vector<const ModelGraph::Edge*> list = graph.getEdgesOfNode(nodeName);
+    edges.reserve(list.size());
+    for(auto edge: list) {
+      edges.push_back(graph.edgeToConfigMap(*edge));
+    }
+    return edges;
+  }
+
   const std::map<std::string, osg_graph_viz::NodeInfo>& Model::getNodeInfoMap() {
-    return infoMap;
+    return nodeInfos();
   }
 
   bool Model::removeNode(unsigned long nodeId) {
-    if(!edition.empty()) {
-      ConfigMap node = nodeMap[nodeId];
-      std::string nodeDomain = tolower((std::string)node["domain"]);
-      std::string nodeName = node["name"];
+    if(edition) {
+      const ModelGraph::Node *node = graph.getNode(nodeId);
+      StringId nodeDomain = node ? graph.strings.lower(node->domain) : 0;
       if(nodeDomain != edition) {
-        if(nodeDomain != "assembly") {
+        if(nodeDomain != assemblyId) {
           return false;
         }
         else {
           // check if there are no edges in other domains
-          for(auto it: edgeMap) {
-            if((std::string)it.second["fromNode"] == nodeName) {
-              if(tolower((std::string)it.second["domain"]) != edition) {
-                return false;
-              }
-            }
-            if((std::string)it.second["toNode"] == nodeName) {
-              if(tolower((std::string)it.second["domain"]) != edition) {
-                return false;
-              }
+          std::vector<const ModelGraph::Edge*> edges;
+          edges = graph.getEdgesOfNode(graph.str(node->name));
+          for(auto edge: edges) {
+            if(graph.strings.lower(edge->domain) != edition) {
+              return false;
             }
           }
         }
       }
     }
 
-    nodeMap.erase(nodeId);
+    setChanged(graph.removeNode(nodeId));
     return true;
   }
 
   bool Model::removeEdge(unsigned long edgeId) {
-    if(edgeMap.find(edgeId) == edgeMap.end()) {
+    const ModelGraph::Edge *edge = graph.getEdge(edgeId);
+    if(!edge) {
       return true;
     }
 
-    ConfigMap &edge = edgeMap[edgeId];
-    if(!edition.empty() && tolower((std::string)edge["domain"]) != edition) {
+    if(edition && graph.strings.lower(edge->domain) != edition) {
       return false;
     }
 
-    edgeMap.erase(edgeId);
+    setChanged(graph.removeEdge(edgeId));
     return true;
   }
 
   bool Model::updateNode(unsigned long nodeId,
                          configmaps::ConfigMap node) {
     if(node["type"] == "DES") return true;
-    std::map<unsigned long, ConfigMap>::iterator it = nodeMap.find(nodeId);
-    if(it != nodeMap.end()) {
+    const ModelGraph::Node *current = graph.getNode(nodeId);
+    if(current) {
       // todo: handle domain namespace in name
       std::string nodeName = node["name"];
-      std::string domain = tolower((std::string)node["domain"]);
-      if(!edition.empty()) {
-        if(edition != domain && nodeName != it->second["name"].getString()) {
-          fprintf(stderr, "ERROR: change node name of non %s nodes is not allowed!", edition.c_str());
+      StringId domain = graph.strings.lower(internString(node["domain"]));
+      if(edition) {
+        if(edition != domain && nodeName != graph.str(current->name)) {
+          fprintf(stderr, "ERROR: change node name of non %s nodes is not allowed!", graph.str(edition).c_str());
           return false;
         }
       }
@@ -550,32 +795,78 @@ namespace xrock_gui_model {
       //if(domain.empty()) return false;
       //domain += "::";
       //if(nodeName.find(domain) != 0) return false;
-      it->second = node;
-      return true;
+      bool updated = graph.updateNode(nodeId, node);
+      setChanged(updated);
+      return updated;
     }
     return false;
   }
 
+  unsigned long Model::getNodeRevision(const std::string &name) const {
+    const ModelGraph::Node *node = graph.findNode(name);
+    return node ? node->revision : 0;
+  }
+
+  unsigned long Model::getEdgeRevision(unsigned long edgeId) const {
+    const ModelGraph::Edge *edge = graph.getEdge(edgeId);
+    return edge ? edge->revision : 0;
+  }
+
   bool Model::hasNodeInfo(const std::string &type) {
-    std::map<std::string, osg_graph_viz::NodeInfo>::iterator it = infoMap.begin();
-    for(; it!=infoMap.end(); ++it) {
-      if(it->first == type) {
-        return true;
-      }
-    }
-    return false;
+    return nodeInfos().find(type) != nodeInfos().end();
   }
 
   configmaps::ConfigMap Model::getNodeInfo(const std::string &type) {
-    std::map<std::string, osg_graph_viz::NodeInfo>::iterator it = infoMap.begin();
-    for(; it!=infoMap.end(); ++it) {
-      if(it->first == type) {
-        return it->second.map;
-      }
+    NodeInfoMap::const_iterator it = nodeInfos().find(type);
+    if(it != nodeInfos().end()) {
+      ConfigMap map = it->second.map;
+      expandData(map);
+      return map;
     }
     return ConfigMap();
   }
 
+  std::string Model::getNodeInfoVersion(const std::string &type) {
+    NodeInfoMap::const_iterator it = nodeInfos().find(type);
+    if(it == nodeInfos().end()) return "";
+    ConfigMap::const_iterator version = it->second.map.find("modelVersion");
+    if(version == it->second.map.end()) return "";
+    return version->second.getString();
+  }
+
+  void Model::expandData(ConfigMap &map) {
+    if(!map.hasKey("domain")) return;
+    std::string domainData = map["domain"].getString() + "Data";
+    if(map.hasKey(domainData) && map[domainData].hasKey("data")) {
+      expandData(map[domainData]["data"]);
+    }
+    if(map.hasKey("defaultConfiguration") &&
+       map["defaultConfiguration"].hasKey("data")) {
+      expandData(map["defaultConfiguration"]["data"]);
+    }
+  }
+
+  void Model::expandData(ConfigItem &data) {
+    if(data.isAtom()) {
+      data = catalog->parseData(data.getString());
+    }
+    else if(data.isMap() && data.hasKey("submodel")) {
+      expandSubmodel(data["submodel"]);
+    }
+  }
+
+  void Model::expandSubmodel(ConfigItem &submodel) {
+    if(!submodel.isVector()) return;
+    for(auto &it: submodel) {
+      if(it.hasKey("data")) {
+        expandData(it["data"]);
+      }
+      if(it.hasKey("submodel")) {
+        expandSubmodel(it["submodel"]);
+      }
+    }
+  }
+
 
   void Model::setModelInfo(configmaps::ConfigMap &map) {
     modelInfo = map;
@@ -590,8 +881,12 @@ namespace xrock_gui_model {
     std::string domainData = domain+"Data";
     std::string modelName = map["modelName"];
     std::string modelVersion = map["modelVersion"];
-    osg_graph_viz::NodeInfo ndi = infoMap[modelName];
-    ConfigMap &model = ndi.map;
+    ConfigMap model;
+    NodeInfoMap::const_iterator it = nodeInfos().find(modelName);
+    if(it != nodeInfos().end()) {
+      model = it->second.map;
+      expandData(model);
+    }
 
     if(map[domainData].hasKey("data")) {
       ConfigMap &rMap = map[domainData]["data"];
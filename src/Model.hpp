@@ -8,9 +8,17 @@
 #define XROCK_GUI_MODEL_HPP
 
 #include <bagel_gui/ModelInterface.hpp>
+#include "ModelGraph.hpp"
+#include "NodeInfoCatalog.hpp"
+
+#include <memory>
+#include <set>
 
 namespace xrock_gui_model {
 
+  class NodeInfoLoader;
+  class DBInterface;
+
   class Model : public bagel_gui::ModelInterface {
   public:
     Model(bagel_gui::BagelGui *bagelGui);
@@ -30,9 +38,11 @@ namespace xrock_gui_model {
     bool updateNode(unsigned long nodeId,
                     configmaps::ConfigMap node);
     bool updateEdge(unsigned long egdeId,
-                    configmaps::ConfigMap edge) {return true;}
+                    configmaps::ConfigMap edge);
     bool removeNode(unsigned long nodeId);
     bool removeEdge(unsigned long edgeId);
+    // returns the incoming and outgoing edges of the node ordered by edge id
+    std::vector<configmaps::ConfigMap> getEdgesOfNode(const std::string &nodeName);
 
     // Import/Export
     void importFromFile(std::string fileName);
@@ -41,27 +51,91 @@ namespace xrock_gui_model {
     bool groupNodes(unsigned long groupNodeId, unsigned long nodeId);
     bool loadSubgraphInfo(const std::string &filename,
                           const std::string &absPath) {return false;}
-    std::map<unsigned long, std::vector<std::string> > getCompatiblePorts(unsigned long nodeId, std::string outPortName) {return std::map<unsigned long, std::vector<std::string> >();}
-    bool handlePortCompatibility() {return false;}
+    std::map<unsigned long, std::vector<std::string> > getCompatiblePorts(unsigned long nodeId, std::string outPortName) {return graph.getCompatibleInputs(nodeId, outPortName);}
+    bool handlePortCompatibility() {return true;}
     const std::map<std::string, osg_graph_viz::NodeInfo>& getNodeInfoMap();
     //void displayWidget( QWidget *pParent );
     bool addNodeInfo(configmaps::ConfigMap &model, std::string version = "");
+    // Starts loading the node infos of all models of the database on a
+    // background thread. The infos are added to all models by
+    // pollDBNodeInfos() which has to be called from the gui thread.
+    void startDBNodeInfos(DBInterface *db);
+    // adds the infos of up to maxModels loaded models, returns true if
+    // the catalog changed
+    static bool pollDBNodeInfos(size_t maxModels);
+    // blocks until the given types are loaded or known to be no part of
+    // the database and adds all loaded infos, returns true if the catalog
+    // changed
+    static bool waitForDBNodeInfos(const std::vector<std::string> &types);
+    // stops the background loading and adds the infos loaded so far,
+    // returns true if the catalog changed
+    static bool cancelDBNodeInfos();
+    // stops the background loading and drops the loaded infos; has to be
+    // called before the program exits
+    static void stopDBNodeInfos();
+    static bool isLoadingDBNodeInfos() {return dbBootstrap != nullptr;}
     bool hasNodeInfo(const std::string &type);
     configmaps::ConfigMap getNodeInfo(const std::string &type);
+    // returns the model version of the type without expanding its data
+    std::string getNodeInfoVersion(const std::string &type);
+    unsigned long getNodeInfoRevision() const {return catalog->revision;}
     void setModelInfo(configmaps::ConfigMap &map);
     configmaps::ConfigMap& getModelInfo();
     void setEdition(std::string v);
     void resetConfig(configmaps::ConfigMap &map);
+    // the revision of a node or edge changes with every update, 0 if the
+    // item is unknown
+    unsigned long getNodeRevision(const std::string &name) const;
+    unsigned long getEdgeRevision(unsigned long edgeId) const;
+    // set whenever a node or edge is added, updated, or removed
+    bool isDirty() const {return dirty;}
+    void clearDirty() {dirty = false;}
+    // counts the changes of the graph, it is not reset by clearDirty()
+    unsigned long getChangeCount() const {return changes;}
+    void setChanged(bool changed=true) {
+      if(changed) {
+        dirty = true;
+        ++changes;
+      }
+    }
+    // defers the index maintenance of the graph while a graph is loaded;
+    // the calls can be nested
+    void beginBatch() {graph.beginBatch();}
+    void endBatch() {graph.endBatch();}
 
   private:
-    std::map<unsigned long, configmaps::ConfigMap> nodeMap;
-    std::map<unsigned long, configmaps::ConfigMap> edgeMap;
-    std::map<std::string, osg_graph_viz::NodeInfo> infoMap;
+    struct DBBootstrap;
+    static std::unique_ptr<DBBootstrap> dbBootstrap;
+    // all existing models, the database infos are added to each of them
+    static std::set<Model*> liveModels;
+
+    ModelGraph graph;
+    std::shared_ptr<NodeInfoCatalog> catalog;
+    // only set while the initial catalog is loaded
+    std::unique_ptr<NodeInfoCatalogCache> catalogCache;
     configmaps::ConfigMap modelInfo;
-    std::string edition;
+    // lower case domain of the edition, 0 if no edition is set
+    StringId edition;
+    bool dirty;
+    unsigned long changes;
 
-    void loadNodeInfo(std::string path, bool orogen=false);
+    void loadNodeInfo(NodeInfoLoader &loader, std::string path,
+                      bool orogen=false);
     bool addOrogenInfo(configmaps::ConfigMap &model);
+    const NodeInfoMap& nodeInfos() const {return catalog->infos;}
+    NodeInfoMap& editNodeInfos();
+    // returns the node infos generated from the model without looking at
+    // the current catalog
+    NodeInfoMap buildNodeInfos(configmaps::ConfigMap &model, bool orogen);
+    // adds the infos which are not yet part of the catalog
+    void mergeNodeInfos(const NodeInfoMap &infos);
+    // merges the infos into the catalog of this model and of all other
+    // models, models sharing the catalog keep sharing it
+    void publishNodeInfos(const NodeInfoMap &infos);
+    // replaces the yaml strings kept in the data fields of a node info
+    void expandData(configmaps::ConfigMap &map);
+    void expandData(configmaps::ConfigItem &data);
+    void expandSubmodel(configmaps::ConfigItem &submodel);
   };
 } // end of namespace xrock_gui_model
 
@@ -0,0 +1,135 @@
+#include "ModelFile.hpp"
+#include "BinaryConfigMap.hpp"
+#include "ConfigMapHelper.hpp"
+#include "PhaseTimer.hpp"
+
+#include <mars/utils/misc.h>
+#include <fstream>
+#include <unordered_set>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  const char *ModelFile::binarySuffix = ".xmb";
+
+  bool ModelFile::isBinary(const std::string &filename) {
+    std::string suffix = binarySuffix;
+    return (filename.size() > suffix.size() &&
+            mars::utils::tolower(filename.substr(filename.size()-suffix.size())) == suffix);
+  }
+
+  bool ModelFile::load(const std::string &filename, ConfigMap &model) {
+    PhaseTimer timer("readModelFile");
+    if(!mars::utils::pathExists(filename)) {
+      return false;
+    }
+    if(isBinary(filename)) {
+      if(!BinaryConfigMap::fromBinaryFile(filename, model)) {
+        fprintf(stderr, "ERROR: reading binary model file: %s\n", filename.c_str());
+        return false;
+      }
+      return true;
+    }
+    try {
+      model = ConfigMap::fromYamlFile(filename, true);
+    } catch(...) {
+      fprintf(stderr, "ERROR: reading model file: %s\n", filename.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool ModelFile::save(ConfigMap &model, const std::string &filename) {
+    PhaseTimer timer("writeModelFile");
+    if(isBinary(filename)) {
+      ConfigMapHelper::unpackData(model);
+      if(!BinaryConfigMap::toBinaryFile(model, filename)) {
+        fprintf(stderr, "ERROR: writing binary model file: %s\n", filename.c_str());
+        return false;
+      }
+      return true;
+    }
+    ConfigMapHelper::packData(model);
+    // toYamlFile() does not report write errors
+    std::ofstream file(filename.c_str());
+    if(file.good()) {
+      file << model.toYamlString();
+      file.close();
+    }
+    if(!file) {
+      fprintf(stderr, "ERROR: writing model file: %s\n", filename.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool ModelFile::validate(ConfigMap &model, std::vector<std::string> &errors) {
+    size_t numErrors = errors.size();
+    const char *keys[3] = {"name", "domain", "type"};
+    for(int i=0; i<3; ++i) {
+      if(!model.hasKey(keys[i])) {
+        errors.push_back(std::string("missing ") + keys[i]);
+      }
+    }
+    if(!model.hasKey("versions") || model["versions"].size() == 0) {
+      errors.push_back("missing versions");
+      return false;
+    }
+    ConfigMap &version = model["versions"][0];
+    if(!version.hasKey("name")) {
+      errors.push_back("missing version name");
+    }
+    if(!version.hasKey("components")) {
+      return errors.size() == numErrors;
+    }
+    ConfigMap &components = version["components"];
+    std::unordered_set<std::string> nodes;
+    if(components.hasKey("nodes")) {
+      for(auto &it: components["nodes"]) {
+        std::string name = it["name"];
+        if(name.empty()) {
+          errors.push_back("node without name");
+          continue;
+        }
+        if(!nodes.insert(name).second) {
+          errors.push_back("duplicate node: " + name);
+        }
+        if(!it.hasKey("model") || !it["model"].hasKey("name") ||
+           !it["model"].hasKey("domain")) {
+          errors.push_back("node without model name or domain: " + name);
+        }
+      }
+    }
+    if(components.hasKey("edges")) {
+      for(auto &it: components["edges"]) {
+        std::string from = it["from"]["name"];
+        std::string to = it["to"]["name"];
+        if(!nodes.count(from) || !nodes.count(to)) {
+          errors.push_back("edge with unknown node: " + from + " -> " + to);
+        }
+        if(it["from"]["interface"].getString().empty() ||
+           it["to"]["interface"].getString().empty()) {
+          errors.push_back("edge without interface: " + from + " -> " + to);
+        }
+      }
+    }
+    if(components.hasKey("configuration") &&
+       components["configuration"].hasKey("nodes")) {
+      for(auto &it: components["configuration"]["nodes"]) {
+        if(!nodes.count(it["name"])) {
+          errors.push_back("configuration of unknown node: " + it["name"].getString());
+        }
+      }
+    }
+    if(version.hasKey("interfaces")) {
+      for(auto &it: version["interfaces"]) {
+        if(it.hasKey("linkToNode") && !nodes.count(it["linkToNode"])) {
+          errors.push_back("interface of unknown node: " + it["name"].getString());
+        }
+      }
+    }
+    return errors.size() == numErrors;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,37 @@
+/**
+ * \file ModelFile.hpp
+ * \brief Reads and writes model files as yaml or in the binary format
+ *
+ * Files with the extension .xmb use the binary format of BinaryConfigMap,
+ * all other files are yaml. In yaml files the data fields are stored as
+ * yaml strings, binary files keep them as maps and thus don't need a
+ * second parse step.
+ **/
+
+#ifndef XROCK_GUI_MODEL_MODEL_FILE_HPP
+#define XROCK_GUI_MODEL_MODEL_FILE_HPP
+
+#include <configmaps/ConfigMap.hpp>
+
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  class ModelFile {
+  public:
+    static const char *binarySuffix;
+
+    static bool isBinary(const std::string &filename);
+    static bool load(const std::string &filename, configmaps::ConfigMap &model);
+    // converts the data fields of the model to the storage mode of the file
+    static bool save(configmaps::ConfigMap &model, const std::string &filename);
+    // checks the structure and the references within versions[0];
+    // the problems found are appended to errors
+    static bool validate(configmaps::ConfigMap &model,
+                         std::vector<std::string> &errors);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_MODEL_FILE_HPP
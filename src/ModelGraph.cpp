@@ -0,0 +1,446 @@
+#include "ModelGraph.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  const unsigned int ModelGraph::npos = (unsigned int)-1;
+
+  // keys which are stored typed and not as part of the payload
+  static const char* nodeKeys[] = {"name", "type", "domain", "xrock_type",
+                                   "modelName", "modelVersion", "inputs",
+                                   "outputs", NULL};
+  static const char* edgeKeys_[] = {"fromNode", "fromNodeOutput", "toNode",
+                                    "toNodeInput", "domain", NULL};
+
+  static bool isKey(const char **keys, const std::string &key) {
+    for(; *keys; ++keys) {
+      if(key == *keys) return true;
+    }
+    return false;
+  }
+
+  size_t ModelGraph::EdgeKeyHash::operator()(const EdgeKey &key) const {
+    size_t seed = key.fromNode;
+    seed ^= key.fromPort + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= key.toNode + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= key.toPort + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+
+  size_t ModelGraph::PortKeyHash::operator()(const PortKey &key) const {
+    size_t seed = key.domain;
+    seed ^= key.type + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= key.input + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+
+  ModelGraph::ModelGraph() : strings(StringTable::global()), unusedPorts(0),
+                             batchDepth(0), portIndexValid(true) {
+    assemblyId = strings.intern("assembly");
+  }
+
+  ModelGraph::PortKey ModelGraph::getPortKey(const Node &node,
+                                             const Port &port,
+                                             bool input) const {
+    PortKey key;
+    // same rule as used by Model::addEdge: the ports of an assembly
+    // define their own domain
+    key.domain = node.domain;
+    if(node.domain == assemblyId) {
+      key.domain = port.domain;
+    }
+    key.type = port.type;
+    key.input = input;
+    return key;
+  }
+
+  void ModelGraph::indexPorts(const Node &node, bool add) const {
+    if(!portIndexValid || node.firstPort == npos) return;
+    const Port *port = ports.data()+node.firstPort;
+    unsigned int numPorts = node.numInputs+node.numOutputs;
+    for(unsigned int i=0; i<numPorts; ++i) {
+      PortKey key = getPortKey(node, port[i], i < node.numInputs);
+      std::pair<unsigned long, StringId> ref(node.id, port[i].name);
+      if(add) {
+        portIndex[key].insert(ref);
+      }
+      else {
+        std::unordered_map<PortKey, PortSet, PortKeyHash>::iterator it = portIndex.find(key);
+        if(it == portIndex.end()) continue;
+        it->second.erase(ref);
+        if(it->second.empty()) portIndex.erase(it);
+      }
+    }
+  }
+
+  StringId ModelGraph::internKey(ConfigMap &map, const char *key) {
+    if(map.hasKey(key)) {
+      return strings.intern(map[key].getString());
+    }
+    return 0;
+  }
+
+  unsigned long ModelGraph::nextRevision() {
+    static unsigned long revision = 0;
+    return ++revision;
+  }
+
+  void ModelGraph::setNode(Node &node, ConfigMap &map) {
+    node.revision = nextRevision();
+    node.name = internKey(map, "name");
+    node.type = internKey(map, "type");
+    node.domain = internKey(map, "domain");
+    node.xrockType = internKey(map, "xrock_type");
+    node.modelName = internKey(map, "modelName");
+    node.modelVersion = internKey(map, "modelVersion");
+    node.payload = ConfigMap();
+    for(ConfigMap::iterator it=map.begin(); it!=map.end(); ++it) {
+      if(!isKey(nodeKeys, it->first)) {
+        node.payload[it->first] = it->second;
+      }
+    }
+  }
+
+  void ModelGraph::setPorts(Node &node, ConfigMap &map) {
+    unsigned int numInputs = map.hasKey("inputs") ? map["inputs"].size() : 0;
+    unsigned int numOutputs = map.hasKey("outputs") ? map["outputs"].size() : 0;
+    if(node.firstPort == npos ||
+       numInputs+numOutputs != node.numInputs+node.numOutputs) {
+      if(node.firstPort != npos) {
+        unusedPorts += node.numInputs+node.numOutputs;
+      }
+      node.firstPort = ports.size();
+      ports.resize(ports.size()+numInputs+numOutputs);
+    }
+    node.numInputs = numInputs;
+    node.numOutputs = numOutputs;
+    unsigned int i = node.firstPort;
+    const char *lists[2] = {"inputs", "outputs"};
+    for(int l=0; l<2; ++l) {
+      if(!map.hasKey(lists[l])) continue;
+      for(ConfigVector::iterator it=map[lists[l]].begin();
+          it!=map[lists[l]].end(); ++it, ++i) {
+        ConfigMap &portMap = *it;
+        ports[i].name = internKey(portMap, "name");
+        ports[i].type = internKey(portMap, "type");
+        ports[i].domain = internKey(portMap, "domain");
+        ports[i].direction = internKey(portMap, "direction");
+      }
+    }
+    if(unusedPorts > 64 && unusedPorts > ports.size()/2) {
+      compactPorts();
+    }
+  }
+
+  void ModelGraph::compactPorts() {
+    std::vector<Port> compact;
+    compact.reserve(ports.size()-unusedPorts);
+    for(std::vector<Node>::iterator it=nodes.begin(); it!=nodes.end(); ++it) {
+      if(!it->valid || it->firstPort == npos) continue;
+      unsigned int first = compact.size();
+      compact.insert(compact.end(), ports.begin()+it->firstPort,
+                     ports.begin()+it->firstPort+it->numInputs+it->numOutputs);
+      it->firstPort = first;
+    }
+    ports.swap(compact);
+    unusedPorts = 0;
+  }
+
+  bool ModelGraph::addNode(unsigned long nodeId, ConfigMap &map) {
+    if(nodeSlots.find(nodeId) != nodeSlots.end()) return false;
+    unsigned int slot;
+    if(freeNodes.empty()) {
+      slot = nodes.size();
+      nodes.push_back(Node());
+    }
+    else {
+      slot = freeNodes.back();
+      freeNodes.pop_back();
+    }
+    Node &node = nodes[slot];
+    node.id = nodeId;
+    node.firstPort = npos;
+    node.numInputs = node.numOutputs = 0;
+    node.valid = true;
+    setNode(node, map);
+    setPorts(node, map);
+    indexPorts(node, true);
+    nodeSlots[nodeId] = slot;
+    nodeByName[node.name] = slot;
+    return true;
+  }
+
+  bool ModelGraph::updateNode(unsigned long nodeId, ConfigMap &map) {
+    std::unordered_map<unsigned long, unsigned int>::iterator it = nodeSlots.find(nodeId);
+    if(it == nodeSlots.end()) return false;
+    unsigned int slot = it->second;
+    Node &node = nodes[slot];
+    StringId oldName = node.name;
+    indexPorts(node, false);
+    setNode(node, map);
+    setPorts(node, map);
+    indexPorts(node, true);
+    if(oldName != node.name) {
+      std::unordered_map<StringId, unsigned int>::iterator nt = nodeByName.find(oldName);
+      if(nt != nodeByName.end() && nt->second == slot) {
+        nodeByName.erase(nt);
+      }
+      nodeByName[node.name] = slot;
+      renameEdgeEndpoints(oldName, node.name);
+    }
+    return true;
+  }
+
+  bool ModelGraph::removeNode(unsigned long nodeId) {
+    std::unordered_map<unsigned long, unsigned int>::iterator it = nodeSlots.find(nodeId);
+    if(it == nodeSlots.end()) return false;
+    unsigned int slot = it->second;
+    Node &node = nodes[slot];
+    std::unordered_map<StringId, unsigned int>::iterator nt = nodeByName.find(node.name);
+    if(nt != nodeByName.end() && nt->second == slot) {
+      nodeByName.erase(nt);
+    }
+    indexPorts(node, false);
+    unusedPorts += node.numInputs+node.numOutputs;
+    node.valid = false;
+    node.payload = ConfigMap();
+    freeNodes.push_back(slot);
+    nodeSlots.erase(it);
+    return true;
+  }
+
+  const ModelGraph::Node* ModelGraph::getNode(unsigned long nodeId) const {
+    std::unordered_map<unsigned long, unsigned int>::const_iterator it = nodeSlots.find(nodeId);
+    if(it == nodeSlots.end()) return NULL;
+    return &nodes[it->second];
+  }
+
+  const ModelGraph::Node* ModelGraph::findNode(const std::string &name) const {
+    StringId id = strings.find(name);
+    if(id == StringTable::invalid) return NULL;
+    std::unordered_map<StringId, unsigned int>::const_iterator it = nodeByName.find(id);
+    if(it == nodeByName.end()) return NULL;
+    return &nodes[it->second];
+  }
+
+  const ModelGraph::Port* ModelGraph::findInput(const Node &node,
+                                                const std::string &name) const {
+    StringId id = strings.find(name);
+    if(id == StringTable::invalid) return NULL;
+    const Port *port = inputs(node);
+    for(unsigned int i=0; i<node.numInputs; ++i) {
+      if(port[i].name == id) return port+i;
+    }
+    return NULL;
+  }
+
+  const ModelGraph::Port* ModelGraph::findOutput(const Node &node,
+                                                 const std::string &name) const {
+    StringId id = strings.find(name);
+    if(id == StringTable::invalid) return NULL;
+    const Port *port = outputs(node);
+    for(unsigned int i=0; i<node.numOutputs; ++i) {
+      if(port[i].name == id) return port+i;
+    }
+    return NULL;
+  }
+
+  std::map<unsigned long, std::vector<std::string> > ModelGraph::getCompatibleInputs(unsigned long nodeId, const std::string &output) const {
+    std::map<unsigned long, std::vector<std::string> > result;
+    const Node *node = getNode(nodeId);
+    if(!node) return result;
+    const Port *port = findOutput(*node, output);
+    if(!port) return result;
+    PortKey key = getPortKey(*node, *port, false);
+    key.input = true;
+    updatePortIndex();
+    std::unordered_map<PortKey, PortSet, PortKeyHash>::const_iterator it = portIndex.find(key);
+    if(it == portIndex.end()) return result;
+    for(auto ref: it->second) {
+      if(ref.first == nodeId) continue;
+      result[ref.first].push_back(str(ref.second));
+    }
+    return result;
+  }
+
+  void ModelGraph::beginBatch() {
+    if(batchDepth++ == 0) {
+      portIndexValid = false;
+    }
+  }
+
+  void ModelGraph::endBatch() {
+    if(batchDepth > 0 && --batchDepth == 0) {
+      updatePortIndex();
+    }
+  }
+
+  void ModelGraph::updatePortIndex() const {
+    if(portIndexValid) return;
+    portIndex.clear();
+    portIndexValid = true;
+    for(auto &it: nodeSlots) {
+      indexPorts(nodes[it.second], true);
+    }
+  }
+
+  ModelGraph::EdgeKey ModelGraph::getEdgeKey(const Edge &edge) {
+    EdgeKey key;
+    key.fromNode = edge.fromNode;
+    key.fromPort = edge.fromPort;
+    key.toNode = edge.toNode;
+    key.toPort = edge.toPort;
+    return key;
+  }
+
+  bool ModelGraph::addEdge(unsigned long edgeId, ConfigMap &map) {
+    if(edgeSlots.find(edgeId) != edgeSlots.end()) return false;
+    unsigned int slot;
+    if(freeEdges.empty()) {
+      slot = edges.size();
+      edges.push_back(Edge());
+    }
+    else {
+      slot = freeEdges.back();
+      freeEdges.pop_back();
+    }
+    Edge &edge = edges[slot];
+    edge.id = edgeId;
+    edge.fromNode = internKey(map, "fromNode");
+    edge.fromPort = internKey(map, "fromNodeOutput");
+    edge.toNode = internKey(map, "toNode");
+    edge.toPort = internKey(map, "toNodeInput");
+    edge.domain = internKey(map, "domain");
+    edge.valid = true;
+    setEdgePayload(edge, map);
+    edgeSlots[edgeId] = slot;
+    registerEdge(slot);
+    return true;
+  }
+
+  void ModelGraph::setEdgePayload(Edge &edge, ConfigMap &map) {
+    edge.revision = nextRevision();
+    edge.payload = ConfigMap();
+    for(ConfigMap::iterator it=map.begin(); it!=map.end(); ++it) {
+      if(!isKey(edgeKeys_, it->first)) {
+        edge.payload[it->first] = it->second;
+      }
+    }
+  }
+
+  bool ModelGraph::updateEdge(unsigned long edgeId, ConfigMap &map) {
+    std::unordered_map<unsigned long, unsigned int>::iterator it = edgeSlots.find(edgeId);
+    if(it == edgeSlots.end()) return false;
+    setEdgePayload(edges[it->second], map);
+    return true;
+  }
+
+  bool ModelGraph::removeEdge(unsigned long edgeId) {
+    std::unordered_map<unsigned long, unsigned int>::iterator it = edgeSlots.find(edgeId);
+    if(it == edgeSlots.end()) return false;
+    unsigned int slot = it->second;
+    unregisterEdge(slot);
+    edges[slot].valid = false;
+    edges[slot].payload = ConfigMap();
+    freeEdges.push_back(slot);
+    edgeSlots.erase(it);
+    return true;
+  }
+
+  const ModelGraph::Edge* ModelGraph::getEdge(unsigned long edgeId) const {
+    std::unordered_map<unsigned long, unsigned int>::const_iterator it = edgeSlots.find(edgeId);
+    if(it == edgeSlots.end()) return NULL;
+    return &edges[it->second];
+  }
+
+  bool ModelGraph::hasEdge(const std::string &fromNode,
+                           const std::string &fromPort,
+                           const std::string &toNode,
+                           const std::string &toPort) const {
+    EdgeKey key;
+    // strings which are not interned can't be part of any edge
+    if((key.fromNode = strings.find(fromNode)) == StringTable::invalid ||
+       (key.fromPort = strings.find(fromPort)) == StringTable::invalid ||
+       (key.toNode = strings.find(toNode)) == StringTable::invalid ||
+       (key.toPort = strings.find(toPort)) == StringTable::invalid) {
+      return false;
+    }
+    return edgeKeys.find(key) != edgeKeys.end();
+  }
+
+  void ModelGraph::registerEdge(unsigned int slot) {
+    const Edge &edge = edges[slot];
+    outEdges[edge.fromNode].push_back(slot);
+    inEdges[edge.toNode].push_back(slot);
+    edgeKeys.insert(getEdgeKey(edge));
+  }
+
+  void ModelGraph::unregisterEdge(unsigned int slot) {
+    const Edge &edge = edges[slot];
+    std::unordered_multiset<EdgeKey, EdgeKeyHash>::iterator it = edgeKeys.find(getEdgeKey(edge));
+    if(it != edgeKeys.end()) {
+      edgeKeys.erase(it);
+    }
+    std::vector<unsigned int> &out = outEdges[edge.fromNode];
+    out.erase(std::remove(out.begin(), out.end(), slot), out.end());
+    if(out.empty()) outEdges.erase(edge.fromNode);
+    std::vector<unsigned int> &in = inEdges[edge.toNode];
+    in.erase(std::remove(in.begin(), in.end(), slot), in.end());
+    if(in.empty()) inEdges.erase(edge.toNode);
+  }
+
+  std::vector<unsigned int> ModelGraph::getEdgeSlots(StringId name) const {
+    std::vector<unsigned int> slots;
+    std::unordered_map<StringId, std::vector<unsigned int> >::const_iterator it;
+    if((it = outEdges.find(name)) != outEdges.end()) {
+      slots.insert(slots.end(), it->second.begin(), it->second.end());
+    }
+    if((it = inEdges.find(name)) != inEdges.end()) {
+      slots.insert(slots.end(), it->second.begin(), it->second.end());
+    }
+    // self connections are part of both lists
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+    return slots;
+  }
+
+  void ModelGraph::renameEdgeEndpoints(StringId oldName, StringId newName) {
+    std::vector<unsigned int> slots = getEdgeSlots(oldName);
+    for(auto slot: slots) {
+      unregisterEdge(slot);
+      Edge &edge = edges[slot];
+      if(edge.fromNode == oldName) edge.fromNode = newName;
+      if(edge.toNode == oldName) edge.toNode = newName;
+      registerEdge(slot);
+    }
+  }
+
+  std::vector<const ModelGraph::Edge*> ModelGraph::getEdgesOfNode(const std::string &name) const {
+    std::vector<const Edge*> result;
+    StringId id = strings.find(name);
+    if(id == StringTable::invalid) return result;
+    std::vector<unsigned int> slots = getEdgeSlots(id);
+    result.reserve(slots.size());
+    for(auto slot: slots) {
+      result.push_back(&edges[slot]);
+    }
+    std::sort(result.begin(), result.end(),
+              [](const Edge *a, const Edge *b) {return a->id < b->id;});
+    return result;
+  }
+
+  ConfigMap ModelGraph::edgeToConfigMap(const Edge &edge) const {
+    ConfigMap map = edge.payload;
+    map["fromNode"] = str(edge.fromNode);
+    map["fromNodeOutput"] = str(edge.fromPort);
+    map["toNode"] = str(edge.toNode);
+    map["toNodeInput"] = str(edge.toPort);
+    map["domain"] = str(edge.domain);
+    return map;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,149 @@
+/**
+ * \file ModelGraph.hpp
+ * \brief Compact typed graph used as storage behind the Model
+ *
+ * Nodes, edges and ports are kept in contiguous arrays and refer to
+ * each other by integer slots. Names, types, domains and directions are
+ * interned strings. Only the free-form part of a node or edge (e.g. the
+ * domain data and configuration) is kept as ConfigMap payload.
+ **/
+
+#ifndef XROCK_GUI_MODEL_MODEL_GRAPH_HPP
+#define XROCK_GUI_MODEL_MODEL_GRAPH_HPP
+
+#include <configmaps/ConfigMap.hpp>
+#include "StringTable.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace xrock_gui_model {
+
+  class ModelGraph {
+  public:
+    static const unsigned int npos;
+
+    struct Port {
+      StringId name, type, domain, direction;
+    };
+
+    struct Node {
+      unsigned long id;
+      StringId name, type, domain, xrockType, modelName, modelVersion;
+      // ports of the node: inputs followed by outputs
+      unsigned int firstPort, numInputs, numOutputs;
+      // changes with every update, unique over all graphs
+      unsigned long revision;
+      bool valid;
+      configmaps::ConfigMap payload;
+    };
+
+    struct Edge {
+      unsigned long id;
+      StringId fromNode, fromPort, toNode, toPort, domain;
+      unsigned long revision;
+      bool valid;
+      configmaps::ConfigMap payload;
+    };
+
+    ModelGraph();
+
+    // the global string table, ids are comparable between models
+    StringTable &strings;
+    const std::string& str(StringId id) const {return strings.str(id);}
+
+    bool addNode(unsigned long nodeId, configmaps::ConfigMap &node);
+    bool updateNode(unsigned long nodeId, configmaps::ConfigMap &node);
+    bool removeNode(unsigned long nodeId);
+    const Node* getNode(unsigned long nodeId) const;
+    const Node* findNode(const std::string &name) const;
+    const Port* inputs(const Node &node) const {return ports.data()+node.firstPort;}
+    const Port* outputs(const Node &node) const {return ports.data()+node.firstPort+node.numInputs;}
+    const Port* findInput(const Node &node, const std::string &name) const;
+    const Port* findOutput(const Node &node, const std::string &name) const;
+    size_t numNodes() const {return nodeSlots.size();}
+    // returns the inputs of all other nodes matching domain and type of
+    // the given output port
+    std::map<unsigned long, std::vector<std::string> > getCompatibleInputs(unsigned long nodeId, const std::string &output) const;
+
+    bool addEdge(unsigned long edgeId, configmaps::ConfigMap &edge);
+    // updates the payload, the end points of an edge can't be changed
+    bool updateEdge(unsigned long edgeId, configmaps::ConfigMap &edge);
+    bool removeEdge(unsigned long edgeId);
+    const Edge* getEdge(unsigned long edgeId) const;
+    bool hasEdge(const std::string &fromNode, const std::string &fromPort,
+                 const std::string &toNode, const std::string &toPort) const;
+    // returns the incoming and outgoing edges of the node ordered by edge id
+    std::vector<const Edge*> getEdgesOfNode(const std::string &name) const;
+    configmaps::ConfigMap edgeToConfigMap(const Edge &edge) const;
+    size_t numEdges() const {return edgeSlots.size();}
+
+    // The port index is not maintained while a batch is open, it is
+    // rebuilt once the last batch ends or when it is needed.
+    void beginBatch();
+    void endBatch();
+
+  private:
+    struct EdgeKey {
+      StringId fromNode, fromPort, toNode, toPort;
+      bool operator==(const EdgeKey &other) const {
+        return (fromNode == other.fromNode && fromPort == other.fromPort &&
+                toNode == other.toNode && toPort == other.toPort);
+      }
+    };
+    struct EdgeKeyHash {
+      size_t operator()(const EdgeKey &key) const;
+    };
+    // ports are indexed by their effective domain, type and direction
+    struct PortKey {
+      StringId domain, type;
+      bool input;
+      bool operator==(const PortKey &other) const {
+        return (domain == other.domain && type == other.type &&
+                input == other.input);
+      }
+    };
+    struct PortKeyHash {
+      size_t operator()(const PortKey &key) const;
+    };
+    typedef std::set<std::pair<unsigned long, StringId> > PortSet;
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<Port> ports;
+    std::vector<unsigned int> freeNodes, freeEdges;
+    size_t unusedPorts;
+
+    StringId assemblyId;
+    std::unordered_map<unsigned long, unsigned int> nodeSlots, edgeSlots;
+    std::unordered_map<StringId, unsigned int> nodeByName;
+    // adjacency lists (edge slots) by node name and the set of all connections
+    std::unordered_map<StringId, std::vector<unsigned int> > outEdges, inEdges;
+    std::unordered_multiset<EdgeKey, EdgeKeyHash> edgeKeys;
+    int batchDepth;
+    mutable bool portIndexValid;
+    mutable std::unordered_map<PortKey, PortSet, PortKeyHash> portIndex;
+
+    static unsigned long nextRevision();
+    void setNode(Node &node, configmaps::ConfigMap &map);
+    void setEdgePayload(Edge &edge, configmaps::ConfigMap &map);
+    StringId internKey(configmaps::ConfigMap &map, const char *key);
+    void setPorts(Node &node, configmaps::ConfigMap &map);
+    void compactPorts();
+    PortKey getPortKey(const Node &node, const Port &port, bool input) const;
+    void indexPorts(const Node &node, bool add) const;
+    void updatePortIndex() const;
+    static EdgeKey getEdgeKey(const Edge &edge);
+    void registerEdge(unsigned int slot);
+    void unregisterEdge(unsigned int slot);
+    void renameEdgeEndpoints(StringId oldName, StringId newName);
+    std::vector<unsigned int> getEdgeSlots(StringId name) const;
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_MODEL_GRAPH_HPP
@@ -13,6 +13,8 @@
 #include "VersionDialog.hpp"
 #include "ConfigureDialog.hpp"
 #include "ConfigMapHelper.hpp"
+#include "PhaseTimer.hpp"
+#include "CndExport.hpp"
 
 #include <lib_manager/LibManager.hpp>
 #include <bagel_gui/BagelGui.hpp>
@@ -48,7 +50,7 @@ namespace xrock_gui_model {
   }
 
   ModelLib::ModelLib(lib_manager::LibManager *theManager) :
-    lib_manager::LibInterface(theManager), model(NULL) {
+    lib_manager::LibInterface(theManager), model(NULL), widget(NULL) {
     fprintf(stderr, "create model\n");
 
     importToBagel = false;
@@ -87,17 +89,31 @@ namespace xrock_gui_model {
         db = new FileDB();
       }
       db->set_dbAddress(prop_dbAddress.sValue);
+      mechanicsCache.setDB(db);
       dbAddress_paramId = prop_dbAddress.paramId;
 
+      // timing report of open, save and export: empty to disable, "stderr"
+      // or a file the reports are appended to
+      mars::cfg_manager::cfgPropertyStruct prop_timingReport;
+      prop_timingReport = cfg->getOrCreateProperty("XRockGUI", "timingReport",
+                                                   std::string(""), this);
+      PhaseTimer::setOutput(prop_timingReport.sValue);
+      timingReport_paramId = prop_timingReport.paramId;
+
+      // spans of the gui and db activity in chrome trace format
+      mars::cfg_manager::cfgPropertyStruct prop_traceFile;
+      prop_traceFile = cfg->getOrCreateProperty("XRockGUI", "traceFile",
+                                                std::string(""), this);
+      PhaseTimer::setTraceFile(prop_traceFile.sValue);
+      traceFile_paramId = prop_traceFile.paramId;
+
     }
     bagelGui = libManager->getLibraryAs<BagelGui>("bagel_gui");
     if(bagelGui) {
       model = new Model(bagelGui);
-      std::vector<std::pair<std::string, std::string>> models = db->requestModelListByDomain("software");
-      for(auto it: models) {
-        ConfigMap modelMap = db->requestModel("software", it.first, "");
-        model->addNodeInfo(modelMap);
-      }
+      // the database types are added to the palette while the gui runs,
+      // see ModelWidget::timerEvent()
+      model->startDBNodeInfos(db);
       bagelGui->addModelInterface("xrock", model);
       bagelGui->createView("xrock", "Model");
       bagelGui->addPlugin(this);
@@ -146,6 +162,8 @@ namespace xrock_gui_model {
 
 
   ModelLib::~ModelLib() {
+    // the loader thread has to end before the static state is destroyed
+    Model::stopDBNodeInfos();
     widget->deinit();
     if (gui) libManager->releaseLibrary("main_gui");
     if (bagelGui) libManager->releaseLibrary("bagel_gui");
@@ -161,6 +179,7 @@ namespace xrock_gui_model {
 
 
   void ModelLib::loadStartModel() {
+    PhaseTimer timer("ModelLib::loadStartModel");
     if(cfg) {
       std::string domain    = "";
       std::string modelName = "";
@@ -260,6 +279,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::menuAction(int action, bool checked) {
+    PhaseTimer timer("ModelLib::menuAction");
     switch(action) {
     case 1:
       {
@@ -513,10 +533,10 @@ namespace xrock_gui_model {
       map["versions"][0]["maturity"] = "INPROGRESS";
       ConfigMap config;
       if(map["versions"][0]["defaultConfiguration"].hasKey("data")) {
-        config = ConfigMap::fromYamlString(map["versions"][0]["defaultConfiguration"]["data"]);
+        config = ConfigMapHelper::getData(map["versions"][0]["defaultConfiguration"]["data"]);
       }
       config["config"]["graphFilename"] = graphFile;
-      map["versions"][0]["defaultConfiguration"]["data"] = config.toYamlString();
+      map["versions"][0]["defaultConfiguration"]["data"] = config;
       bool success = db->storeModel(map);
       if(success) {
         message.setText("The Bagel Task was successfully stored!");
@@ -529,6 +549,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::createBagelModel() {
+    PhaseTimer timer("ModelLib::createBagelModel");
     ModelInterface *model = bagelGui->getCurrentModel();
     if(model) {
       ConfigMap localMap = model->getModelInfo();
@@ -578,6 +599,10 @@ namespace xrock_gui_model {
             }
           }
         }
+        Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+        if(model) {
+          model->beginBatch();
+        }
         ConfigVector::iterator it = motorMap["motors"].begin();
         double step = 22.0;
         double n=(motorMap["motors"].size()*1.)*step;
@@ -603,6 +628,9 @@ namespace xrock_gui_model {
           }
           n -= step;
         }
+        if(model) {
+          model->endBatch();
+        }
       }
       widget->loadType("software", "PIPE", "v1.0.0");
       widget->loadType("software", "SIN", "v1.0.0");
@@ -622,12 +650,14 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::requestModel() {
+    PhaseTimer timer("ModelLib::requestModel");
     importToBagel = false;
     ImportDialog id(this, true);
     id.exec();
   }
 
   void ModelLib::addComponent(std::string domain, std::string modelName, std::string version, std::string nodeName) {
+    PhaseTimer timer("ModelLib::addComponent");
     // create type name by using domain as namespace
     domain = mars::utils::tolower(domain);
     std::string type = modelName;
@@ -646,6 +676,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::loadComponent(std::string domain, std::string modelName, std::string version) {
+    PhaseTimer timer("ModelLib::loadComponent");
     ConfigMap map = db->requestModel(domain, modelName, version, !version.empty());
     std::cout << "loadComponent: " << map.toJsonString() << std::endl;
     if(importToBagel) {
@@ -656,92 +687,52 @@ namespace xrock_gui_model {
     }
   }
 
-  void ModelLib::loadNodes(bagel_gui::BagelModel *model,
-                           configmaps::ConfigMap &nodes, std::string path,
-                           std::vector<std::string> *nodesFound) {
-    ConfigVector::iterator it = nodes["nodes"].begin();
-    for(; it!=nodes["nodes"].end(); ++it) {
-      if((*it)["model"]["domain"] == "mechanics") {
-        std::string modelName = (*it)["model"]["name"];
-        std::string name = (*it)["name"];
-        if(!path.empty()) {
-          name = path+"_"+name;
-        }
-        if(modelName == "motor_universal") {
-          if(!model->hasNode(name)) {
-            bagelGui->addNode("OUTPUT", name);
-          }
-          nodesFound->push_back((*it)["name"]);
-        }
-        else {
-          ConfigMap map;
-          std::map<std::string, ConfigMap>::iterator it = modelCache.find(modelName);
-          if(it != modelCache.end()) {
-            map = it->second;
-          }
-          else {
-            map = db->requestModel("mechanics", modelName, std::string("v1"));
-            modelCache[modelName] = map;
-          }
-          handleModelMap(model, map, name);
-        }
+  void ModelLib::addMechanics(bagel_gui::BagelModel *model,
+                              const MechanicsCache::Expansion &expansion,
+                              const std::string &path) {
+    for(auto &it: expansion.items) {
+      std::string name = MechanicsCache::childPath(path, it.name);
+      if(it.submodel) {
+        addMechanics(model, *it.submodel, name);
       }
-    }
-  }
-
-  void ModelLib::handleModelMap(bagel_gui::BagelModel *model,
-                                configmaps::ConfigMap &map,
-                                std::string path)
-  {
-    ConfigMap cMap;
-    std::vector<std::string> nodesFound;
-    if(map.hasKey("versions")) {
-      if(map["versions"][0].hasKey("components")) {
-        cMap = ConfigMap::fromYamlString(map["versions"][0]["components"]);
+      else if(!model->hasNode(name)) {
+        bagelGui->addNode("OUTPUT", name);
       }
     }
-    if(cMap.hasKey("nodes")) {
-      loadNodes(model, cMap, path, &nodesFound);
-    }
     // check if we have links in data
-    if(map["versions"][0].hasKey("mechanicsData") &&
-       map["versions"][0]["mechanicsData"].hasKey("data")) {
-      ConfigMap data = ConfigMap::fromYamlString(map["versions"][0]["mechanicsData"]["data"]);
-      if(data.hasKey("bagel_control")) {
-        std::string bagelControl = data["bagel_control"];
-        if(!model->hasNodeInfo(bagelControl)) {
-          // todo: handle path via config or database?
-          QFileInfo fi("../mars_bagel/bagel/");
-          model->loadSubgraphInfo(bagelControl, fi.absoluteFilePath().toStdString());
-          bagelGui->updateNodeTypes();
-        }
-        std::string nodeName = path+"_"+bagelControl.substr(0,bagelControl.size()-4);
-        if(!model->hasNode(nodeName)) {
-          bagelGui->addNode(bagelControl, nodeName);
-        }
-        const ConfigMap *nodeMap_ = bagelGui->getNodeMap(nodeName);
-        if(!nodeMap_) {
-          return;
-        }
-        ConfigMap nodeMap = *nodeMap_;
-        std::vector<std::string>::iterator it=nodesFound.begin();
-        for(; it!=nodesFound.end(); ++it) {
-          if(!model->hasConnection(path+"_"+*it)) {
-            // create edge info if available
-            ConfigVector::iterator it2 = nodeMap["outputs"].begin();
-            for(; it2!=nodeMap["outputs"].end(); ++it2) {
-              if((*it2)["name"] == *it) {
-                ConfigMap edge;
-                edge["fromNode"] = nodeName;
-                edge["fromNodeOutput"] = *it;
-                edge["toNode"] = path+"_"+*it;
-                edge["toNodeInput"] = "in1";
-                edge["weight"] = 1.0;
-                edge["smooth"] = true;
-                bagelGui->addEdge(edge);
-                break;
-              }
-            }
+    if(expansion.bagelControl.empty()) return;
+    const std::string &bagelControl = expansion.bagelControl;
+    if(!model->hasNodeInfo(bagelControl)) {
+      // todo: handle path via config or database?
+      QFileInfo fi("../mars_bagel/bagel/");
+      model->loadSubgraphInfo(bagelControl, fi.absoluteFilePath().toStdString());
+      bagelGui->updateNodeTypes();
+    }
+    std::string nodeName = path+"_"+bagelControl.substr(0,bagelControl.size()-4);
+    if(!model->hasNode(nodeName)) {
+      bagelGui->addNode(bagelControl, nodeName);
+    }
+    const ConfigMap *nodeMap_ = bagelGui->getNodeMap(nodeName);
+    if(!nodeMap_) {
+      return;
+    }
+    ConfigMap nodeMap = *nodeMap_;
+    std::vector<std::string>::const_iterator it=expansion.motors.begin();
+    for(; it!=expansion.motors.end(); ++it) {
+      if(!model->hasConnection(path+"_"+*it)) {
+        // create edge info if available
+        ConfigVector::iterator it2 = nodeMap["outputs"].begin();
+        for(; it2!=nodeMap["outputs"].end(); ++it2) {
+          if((*it2)["name"] == *it) {
+            ConfigMap edge;
+            edge["fromNode"] = nodeName;
+            edge["fromNodeOutput"] = *it;
+            edge["toNode"] = path+"_"+*it;
+            edge["toNodeInput"] = "in1";
+            edge["weight"] = 1.0;
+            edge["smooth"] = true;
+            bagelGui->addEdge(edge);
+            break;
           }
         }
       }
@@ -759,8 +750,8 @@ namespace xrock_gui_model {
         return;
       }
     }
-    modelCache.clear();
-    handleModelMap(model, map, "");
+    // the expansions are kept between imports, see MechanicsCache
+    addMechanics(model, *mechanicsCache.expand(map), "");
   }
 
   void ModelLib::currentModelChanged(bagel_gui::ModelInterface *model) {
@@ -772,6 +763,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::changeNodeVersion(const std::string &name) {
+    PhaseTimer timer("ModelLib::changeNodeVersion");
     versionChangeName = name;
     const ConfigMap *node_ = bagelGui->getNodeMap(name);
     if(!node_) return;
@@ -784,6 +776,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::configureNode(const std::string &name) {
+    PhaseTimer timer("ModelLib::configureNode");
     ConfigMap node = *(bagelGui->getNodeMap(name));
     ConfigMap config;
     std::string domain = node["domain"];
@@ -876,6 +869,7 @@ namespace xrock_gui_model {
                                               const std::string &portName,
                                               const std::string portType)
   {
+    PhaseTimer timer("ModelLib::openConfigureInterfaceDialog");
     if(portType != "outputs" &&
        portType != "inputs")
     {
@@ -953,18 +947,10 @@ namespace xrock_gui_model {
    *       warn if edges can not be reconnected (dropdown optional)
    */
   void ModelLib::selectVersion(std::string version) {
+    PhaseTimer timer("ModelLib::selectVersion");
     Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
     if (model) {
-      std::vector<ConfigMap> edgeList;
-      ConfigMap graph = bagelGui->createConfigMap();
-      for(auto it: graph["edges"]) {
-        if(it["fromNode"] == versionChangeName) {
-          edgeList.push_back(it);
-        }
-        else if(it["toNode"] == versionChangeName) {
-          edgeList.push_back(it);
-        }
-      }
+      std::vector<ConfigMap> edgeList = model->getEdgesOfNode(versionChangeName);
       ConfigMap node = *(bagelGui->getNodeMap(versionChangeName));
       bagelGui->removeNode(versionChangeName);
       std::string domain = node["domain"];
@@ -1027,254 +1013,14 @@ namespace xrock_gui_model {
     }
   }
 
-  void trimMap(ConfigItem &item) {
-    if(item.isMap()) {
-      ConfigMap::iterator it = item.beginMap();
-      while(it != item.endMap()) {
-        if(it->second.isAtom()) {
-          std::string value = mars::utils::trim(it->second.toString());
-          if(value.empty()) {
-            item.erase(it);
-            it = item.beginMap();
-          }
-          else {
-            ++it;
-          }
-        }
-        else if(it->second.isMap() || it->second.isVector()) {
-          // todo: handle empty map
-          trimMap(it->second);
-          if(it->second.size() == 0) {
-            item.erase(it);
-            it = item.beginMap();
-          }
-          else {
-            ++it;
-          }
-        }
-        else {
-          item.erase(it);
-          it = item.beginMap();
-        }
-      }
-    }
-    else if(item.isVector()) {
-
-      ConfigVector::iterator it = item.begin();
-      while(it!=item.end()) {
-        if(it->isAtom()) {
-          std::string value = mars::utils::trim(it->toString());
-          if(value.empty()) {
-            item.erase(it);
-            it = item.begin();
-          }
-          else {
-            ++it;
-          }
-        }
-        else if(it->isMap() || it->isVector()) {
-          trimMap(*it);
-          if(it->size() == 0) {
-            item.erase(it);
-            it = item.begin();
-          }
-          else {
-            ++it;
-          }
-        }
-        else {
-          item.erase(it);
-          it = item.begin();
-        }
-      }
-    }
-  }
-
-  void ModelLib::exportCnd(const configmaps::ConfigMap &map_,
+  void ModelLib::exportCnd(const configmaps::ConfigMap &map,
                            const std::string &filename) {
-    ConfigMap map = map_;
-    ConfigMap output;
-    ConfigMap nameMap;
-    ConfigMap dNameMap;
-    bool haveMarsTask = false;
-    bool compileDeployments = false;
-
-    std::list<ConfigMap>::iterator listIt;
-    // handle file path and node order
-    for(auto node: map["nodes"]) {
-      if(node["type"] == "software::Deployment") {
-        std::string name = node["name"];
-
-        output["deployments"][name]["deployer"] = "orogen";
-        output["deployments"][name]["process_name"] = name;
-        output["deployments"][name]["hostID"] = "local";
-        if(node.hasKey("softwareData") and node["softwareData"].hasKey("data") and
-           node["softwareData"]["data"].hasKey("configuration")) {
-          ConfigItem item(node["softwareData"]["data"]["configuration"]);
-          trimMap(item);
-          ConfigMap m = item;
-          if(m.hasKey("deployer")) {
-            output["deployments"][name]["deployer"] = m["deployer"];
-          }
-          if(m.hasKey("process_name")) {
-            output["deployments"][name]["process_name"] = m["process_name"];
-          }
-          if(m.hasKey("hostID")) {
-            output["deployments"][name]["hostID"] = m["hostID"];
-          }
-        }
-        dNameMap[name] = output["deployments"][name]["process_name"];
-      }
-      else {
-        if(node["domain"] == "software") {
-          std::string name = node["name"];
-          nameMap[name] = 1;
-          ConfigItem item(node["softwareData"]["data"]);
-          trimMap(item);
-          ConfigMap m = item;
-          if(m.hasKey("properties")) {
-            ConfigVector props;
-            for(auto prop: m["properties"]) {
-              if(prop.hasKey("Value")) {
-                props.push_back(prop);
-              }
-            }
-            m.erase("properties");
-            if(props.size() > 0) {
-              m["properties"] = props;
-            }
-          }
-          if(m.hasKey("configuration")) {
-            ConfigMap m2 = m["configuration"];
-            m.erase("configuration");
-            m.updateMap(m2);
-          }
-          if(m.hasKey("description")) {
-            m.erase("description");
-          }
-          std::string type = node["modelName"];
-          if(type == "mars::Task") {
-            haveMarsTask = true;
-          }
-          output["tasks"][name] = m;
-          output["tasks"][name]["type"] = type;
-          if(node.hasKey("parentName") and node["parentName"].getString().size() > 0) {
-            std::string parent = node["parentName"];
-            std::vector<std::string> arrName = mars::utils::explodeString(':', node["type"]);
-            std::string process_name = "orogen_default_"+arrName[0]+"__"+arrName[2];
-            output["deployments"][parent]["taskList"][name] = process_name;
-            if(output["deployments"][parent]["taskList"].size() > 1) {
-              compileDeployments = true;
-              output["deployments"][parent]["process_name"] = dNameMap[parent];
-            }
-            else {
-              output["deployments"][parent]["process_name"] = process_name;
-            }
-          }
-          else {
-            std::string depName = name+"_deployment";
-            output["deployments"][depName]["deployer"] = "orogen";
-            output["deployments"][depName]["hostID"] = "local";
-            std::vector<std::string> arrName = mars::utils::explodeString(':', node["type"]);
-            std::string process_name = "orogen_default_"+arrName[0]+"__"+arrName[2];
-            output["deployments"][depName]["taskList"][name] = process_name;
-            output["deployments"][depName]["process_name"] = process_name;
-            dNameMap[depName] = depName;
-          }
-        }
-      }
-    }
-    if(compileDeployments) {
-      for(ConfigMap::iterator it=output["deployments"].beginMap();
-          it!=output["deployments"].endMap(); ++it) {
-        for(ConfigMap::iterator nt=it->second["taskList"].beginMap();
-            nt!=it->second["taskList"].endMap(); ++nt) {
-          nt->second = nt->first;
-        }
-        output["deployments"][it->first]["process_name"] = dNameMap[it->first];
-      }
-    }
-    int i=0;
-    for(auto edge: map["edges"]) {
-      ConfigMap m;
-      if(edge.hasKey("transport")) {
-        m["transport"] = edge["transport"];
-      }
-      if(edge.hasKey("type")) {
-        m["type"] = edge["type"];
-      }
-      if(edge.hasKey("size")) {
-        m["size"] = edge["size"];
-      }
-      std::string name = edge["fromNode"];
-      if(!nameMap.hasKey(name)) continue;
-      // remove domian namespace
-      m["from"]["task_id"] = name;
-      m["from"]["port_name"] = edge["fromNodeOutput"];
-      // remove domian namespace
-      name << edge["toNode"];
-      if(!nameMap.hasKey(name)) continue;
-      m["to"]["task_id"] = name;
-      m["to"]["port_name"] = edge["toNodeInput"];
-      char buffer[100];
-      // todo: use snprintf
-      sprintf(buffer, "%d", i++);
-      output["connections"][std::string(buffer)] = m;
-    }
-    output.toYamlFile(filename);
-    if(haveMarsTask) {
-      // generate pre cnd because we have to first load mars::Task then
-      // the plugin tasks
-      for(ConfigMap::iterator it = output["tasks"].beginMap();
-          it != output["tasks"].endMap(); ++it) {
-        if(it->second["type"] != "mars::Task") {
-          it->second["state"] = "PRE_OPERATIONAL";
-        }
-      }
-      std::string preFile = filename;
-      mars::utils::removeFilenameSuffix(&preFile);
-      if(output.hasKey("connections")) {
-        output.erase("connections");
-      }
-      output.toYamlFile(preFile+"_pre.cnd");
-    }
-    // write shutdown cnd
-    std::string shutdownFile = mars::utils::pathJoin(mars::utils::getPathOfFile(filename), "shutdown.cnd");
-    FILE *f = fopen(shutdownFile.c_str(), "w");
-    fprintf(f, "deployments:\n\ntasks:\n\nconnections:\n\n");
-    fclose(f);
+    CndExport::exportCnd(map, filename);
   }
 
   void ModelLib::importCND(const std::string &fileName) {
-    ConfigMap map;
-    ConfigMap cnd = ConfigMap::fromYamlFile(fileName);
-    std::string name = fileName;
-    mars::utils::removeFilenamePrefix(&name);
-    mars::utils::removeFilenameSuffix(&name);
-    map["name"] = name;
-    map["domain"] = "SOFTWARE";
-    map["type"] = "CND";
-    map["versions"][0]["name"] = "v0.0.1";
-    map["versions"][0]["projectName"] = "";
-    map["versions"][0]["designedBy"] = "";
-    map["versions"][0]["date"] = QDateTime::currentDateTime().toString(Qt::ISODate).toStdString();
-    map["versions"][0]["components"]["nodes"] = ConfigVector();
-    map["versions"][0]["components"]["edges"] = ConfigVector();
-    if(cnd.hasKey("tasks")) {
-      for(auto it: (ConfigMap)cnd["tasks"]) {
-        fprintf(stderr, "task name: %s\n", it.first.c_str());
-        ConfigMap node;
-        node["name"] = it.first.c_str();
-        node["model"]["domain"] = "SOFTWARE";
-        node["model"]["version"] = "v0.0.1";
-        node["model"]["name"] = it.second["type"];
-        map["versions"][0]["components"]["nodes"].push_back(node);
-        ConfigMap config;
-        config["data"] = it.second.toYamlString();
-        config["name"] = node["name"];
-        map["versions"][0]["components"]["configuration"]["nodes"].push_back(config);
-      }
-    }
+    PhaseTimer timer("ModelLib::importCND");
+    ConfigMap map = CndExport::importCnd(fileName);
     map["modelPath"] = mars::utils::getPathOfFile(fileName);
     map.toYamlFile("da.yml");
     widget->loadModel(map);
@@ -1320,7 +1066,7 @@ namespace xrock_gui_model {
       std::string domainData = domain + "Data";
       if(modelMap["versions"][0].hasKey(domainData)) {
         if(modelMap["versions"][0][domainData].hasKey("data")) {
-          ConfigMap dataMap = ConfigMap::fromYamlString(modelMap["versions"][0][domainData]["data"]);
+          ConfigMap dataMap = ConfigMapHelper::getData(modelMap["versions"][0][domainData]["data"]);
           if(dataMap.hasKey("description")) {
             if(dataMap["description"].hasKey("markdown")) {
               std::string md = dataMap["description"]["markdown"];
@@ -1432,6 +1178,7 @@ namespace xrock_gui_model {
   }
 
   void ModelLib::applyConfiguration(configmaps::ConfigMap &map) {
+    PhaseTimer timer("ModelLib::applyConfiguration");
     if(map["domain"] != "software") return;
     Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
     if(!model) return;
@@ -1486,8 +1233,20 @@ namespace xrock_gui_model {
 
   void ModelLib::cfgUpdateProperty(mars::cfg_manager::cfgPropertyStruct p) {
     if(p.paramId == dbAddress_paramId) {
+      if(Model::cancelDBNodeInfos() && bagelGui) {
+        bagelGui->updateNodeTypes();
+      }
       db->set_dbAddress(p.sValue);
+      // the types of the new database are added to the catalog
+      if(model) {
+        model->startDBNodeInfos(db);
+        if(widget) widget->watchCatalog();
+      }
     } else if(p.paramId == dbUser_paramId) {
+    } else if(p.paramId == timingReport_paramId) {
+      PhaseTimer::setOutput(p.sValue);
+    } else if(p.paramId == traceFile_paramId) {
+      PhaseTimer::setTraceFile(p.sValue);
     }
   }
 
@@ -17,6 +17,7 @@
 #include <bagel_gui/PluginInterface.hpp>
 #include <mars/cfg_manager/CFGManagerInterface.h>
 #include "DBInterface.hpp"
+#include "MechanicsCache.hpp"
 
 namespace bagel_gui {
   class BagelModel;
@@ -53,9 +54,10 @@ namespace xrock_gui_model {
 
     // MenuInterface methods
     void menuAction(int action, bool checked = false);
-    void loadNodes(bagel_gui::BagelModel *model, configmaps::ConfigMap &nodes, std::string path,
-                   std::vector<std::string> *nodesFound);
-    void handleModelMap(bagel_gui::BagelModel *model, configmaps::ConfigMap &map, std::string path);
+    // adds the motors and bagel controls of an expanded mechanics model
+    void addMechanics(bagel_gui::BagelModel *model,
+                      const MechanicsCache::Expansion &expansion,
+                      const std::string &path);
     void mechanicsToBagel(configmaps::ConfigMap &map);
     void currentModelChanged(bagel_gui::ModelInterface *model);
     void changeNodeVersion(const std::string &name);
@@ -83,7 +85,7 @@ namespace xrock_gui_model {
     DBInterface *db;
 
   private:
-    std::map<std::string, configmaps::ConfigMap> modelCache;
+    MechanicsCache mechanicsCache;
     Model *model;
     mars::main_gui::GuiInterface *gui;
     bagel_gui::BagelGui *bagelGui;
@@ -95,6 +97,8 @@ namespace xrock_gui_model {
     mars::cfg_manager::cfgParamId dbAddress_paramId;
     mars::cfg_manager::cfgParamId dbUser_paramId;
     mars::cfg_manager::cfgParamId dbPassword_paramId;
+    mars::cfg_manager::cfgParamId timingReport_paramId;
+    mars::cfg_manager::cfgParamId traceFile_paramId;
     std::string lastExecFolder;
 
     void loadStartModel();
@@ -0,0 +1,273 @@
+#include "ModelStreamReader.hpp"
+
+#include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  namespace {
+
+    // Writes parser events back to yaml. Quoted scalars stay quoted so
+    // that strings like "1" keep their type; anchors are dropped.
+    class EventEmitter {
+    public:
+      EventEmitter(YAML::Emitter &out) : out(out) {}
+
+      void null() {
+        out << YAML::Null;
+      }
+
+      void scalar(const std::string &tag, const std::string &value) {
+        if(tag == "!") {
+          out << YAML::DoubleQuoted << value;
+        }
+        else {
+          if(!tag.empty() && tag != "?") out << YAML::VerbatimTag(tag);
+          out << value;
+        }
+      }
+
+      void beginSeq(const std::string &tag, YAML::EmitterStyle::value style) {
+        props(tag, style);
+        out << YAML::BeginSeq;
+      }
+
+      void endSeq() {
+        out << YAML::EndSeq;
+      }
+
+      void beginMap(const std::string &tag, YAML::EmitterStyle::value style) {
+        props(tag, style);
+        out << YAML::BeginMap;
+      }
+
+      void endMap() {
+        out << YAML::EndMap;
+      }
+
+    private:
+      YAML::Emitter &out;
+
+      void props(const std::string &tag, YAML::EmitterStyle::value style) {
+        if(!tag.empty() && tag != "?" && tag != "!") {
+          out << YAML::VerbatimTag(tag);
+        }
+        if(style == YAML::EmitterStyle::Flow) {
+          out << YAML::Flow;
+        }
+      }
+    };
+
+    class StreamHandler : public YAML::EventHandler {
+    public:
+      StreamHandler(const ModelStreamReader::ItemCallback &onItem,
+                    const ModelStreamReader::ScalarCallback &onScalar) :
+        onItem(onItem), onScalar(onScalar), restEvents(rest), depth(0) {}
+
+      YAML::Emitter rest;
+
+      void OnDocumentStart(const YAML::Mark &mark) {}
+      void OnDocumentEnd() {}
+
+      void OnNull(const YAML::Mark &mark, YAML::anchor_t anchor) {
+        if(beginItem()) {
+          itemEvents->null();
+          endItem();
+          return;
+        }
+        restEvents.null();
+        scalar("");
+      }
+
+      void OnAlias(const YAML::Mark &mark, YAML::anchor_t anchor) {
+        if(beginItem()) {
+          itemEvents->null();
+          endItem();
+          return;
+        }
+        restEvents.null();
+        scalar("");
+      }
+
+      void OnScalar(const YAML::Mark &mark, const std::string &tag,
+                    YAML::anchor_t anchor, const std::string &value) {
+        if(beginItem()) {
+          itemEvents->scalar(tag, value);
+          endItem();
+          return;
+        }
+        restEvents.scalar(tag, value);
+        if(stack.size() == 1 && stack[0].isMap && !stack[0].expectKey &&
+           onScalar) {
+          onScalar(stack[0].key, value);
+        }
+        scalar(value);
+      }
+
+      void OnSequenceStart(const YAML::Mark &mark, const std::string &tag,
+                           YAML::anchor_t anchor,
+                           YAML::EmitterStyle::value style) {
+        if(beginItem()) {
+          itemEvents->beginSeq(tag, style);
+          ++depth;
+          return;
+        }
+        restEvents.beginSeq(tag, style);
+        push(false);
+      }
+
+      void OnSequenceEnd() {
+        if(itemEvents) {
+          itemEvents->endSeq();
+          --depth;
+          endItem();
+          return;
+        }
+        restEvents.endSeq();
+        pop();
+      }
+
+      void OnMapStart(const YAML::Mark &mark, const std::string &tag,
+                      YAML::anchor_t anchor, YAML::EmitterStyle::value style) {
+        if(beginItem()) {
+          itemEvents->beginMap(tag, style);
+          ++depth;
+          return;
+        }
+        restEvents.beginMap(tag, style);
+        push(true);
+      }
+
+      void OnMapEnd() {
+        if(itemEvents) {
+          itemEvents->endMap();
+          --depth;
+          endItem();
+          return;
+        }
+        restEvents.endMap();
+        pop();
+      }
+
+      void OnAnchor(const YAML::Mark &mark, const std::string &name) {}
+
+    private:
+      struct Frame {
+        bool isMap, expectKey, isKey;
+        // current key of a map and current index of a sequence
+        std::string key;
+        size_t index;
+      };
+
+      const ModelStreamReader::ItemCallback &onItem;
+      const ModelStreamReader::ScalarCallback &onScalar;
+      EventEmitter restEvents;
+      std::vector<Frame> stack;
+      std::unique_ptr<YAML::Emitter> item;
+      std::unique_ptr<EventEmitter> itemEvents;
+      std::string itemList;
+      int depth;
+
+      // returns the name of the list if the next value is one of the
+      // streamed items: versions[0].components.(nodes|edges)[i]
+      const std::string* streamedList() const {
+        if(stack.size() != 5) return NULL;
+        if(!stack[0].isMap || stack[0].key != "versions") return NULL;
+        if(stack[1].isMap || stack[1].index != 0) return NULL;
+        if(!stack[2].isMap || stack[2].key != "components") return NULL;
+        if(!stack[3].isMap ||
+           (stack[3].key != "nodes" && stack[3].key != "edges")) return NULL;
+        if(stack[4].isMap) return NULL;
+        return &stack[3].key;
+      }
+
+      bool beginItem() {
+        if(itemEvents) return true;
+        const std::string *list = streamedList();
+        if(!list) return false;
+        itemList = *list;
+        item.reset(new YAML::Emitter());
+        itemEvents.reset(new EventEmitter(*item));
+        depth = 0;
+        return true;
+      }
+
+      void endItem() {
+        if(depth > 0) return;
+        std::string yaml = item->c_str();
+        itemEvents.reset();
+        item.reset();
+        valueDone();
+        onItem(itemList, yaml);
+      }
+
+      void valueDone() {
+        if(stack.empty()) return;
+        Frame &top = stack.back();
+        if(top.isMap) {
+          top.expectKey = true;
+        }
+        else {
+          ++top.index;
+        }
+      }
+
+      void scalar(const std::string &value) {
+        if(!stack.empty() && stack.back().isMap && stack.back().expectKey) {
+          stack.back().key = value;
+          stack.back().expectKey = false;
+          return;
+        }
+        valueDone();
+      }
+
+      void push(bool isMap) {
+        Frame frame;
+        frame.isMap = isMap;
+        frame.expectKey = true;
+        frame.index = 0;
+        // a collection used as key
+        frame.isKey = (!stack.empty() && stack.back().isMap &&
+                       stack.back().expectKey);
+        if(frame.isKey) {
+          stack.back().key = "";
+          stack.back().expectKey = false;
+        }
+        stack.push_back(frame);
+      }
+
+      void pop() {
+        bool isKey = stack.back().isKey;
+        stack.pop_back();
+        if(!isKey) {
+          valueDone();
+        }
+      }
+    };
+
+  } // end of anonymous namespace
+
+  bool ModelStreamReader::read(std::istream &in, const ItemCallback &onItem,
+                               const ScalarCallback &onScalar,
+                               std::string *rest) {
+    try {
+      YAML::Parser parser(in);
+      StreamHandler handler(onItem, onScalar);
+      if(!parser.HandleNextDocument(handler)) {
+        return false;
+      }
+      if(rest) {
+        *rest = handler.rest.c_str();
+      }
+    } catch(YAML::Exception &e) {
+      fprintf(stderr, "ERROR: reading model: %s\n", e.what());
+      return false;
+    }
+    return true;
+  }
+
+} // end of namespace xrock_gui_model
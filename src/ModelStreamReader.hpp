@@ -0,0 +1,35 @@
+/**
+ * \file ModelStreamReader.hpp
+ * \brief Event based reader for large model files
+ *
+ * The nodes and edges of versions[0].components are handed to a callback
+ * one by one while the file is parsed and are not kept afterwards. The
+ * scalar entries of the top level map are reported when they are read,
+ * the rest of the document is returned as yaml once the file is read.
+ * Anchors and aliases are not supported across item boundaries.
+ **/
+
+#ifndef XROCK_GUI_MODEL_MODEL_STREAM_READER_HPP
+#define XROCK_GUI_MODEL_MODEL_STREAM_READER_HPP
+
+#include <functional>
+#include <istream>
+#include <string>
+
+namespace xrock_gui_model {
+
+  class ModelStreamReader {
+  public:
+    // list is "nodes" or "edges", item is the yaml of one entry
+    typedef std::function<void(const std::string &list,
+                               const std::string &item)> ItemCallback;
+    typedef std::function<void(const std::string &key,
+                               const std::string &value)> ScalarCallback;
+
+    static bool read(std::istream &in, const ItemCallback &onItem,
+                     const ScalarCallback &onScalar, std::string *rest);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_MODEL_STREAM_READER_HPP
@@ -3,6 +3,10 @@
 #include "Model.hpp"
 #include "ConfigureDialog.hpp"
 #include "ConfigMapHelper.hpp"
+#include "ModelFile.hpp"
+#include "ModelStreamReader.hpp"
+#include "PhaseTimer.hpp"
+#include "InterfaceSet.hpp"
 
 #include <QVBoxLayout>
 #include <QLabel>
@@ -13,16 +17,30 @@
 #include <QFileDialog>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QTimerEvent>
+#include <QProgressDialog>
+#include <QApplication>
+#include <QEventLoop>
 #include <bagel_gui/BagelGui.hpp>
 #include <bagel_gui/BagelModel.hpp>
 #include <mars/utils/misc.h>
 #include <QDesktopServices>
 
+#include <set>
+#include <vector>
+#include <fstream>
+#include <sys/stat.h>
+#include <memory>
+#include <unordered_set>
+
 
 using namespace configmaps;
 
 namespace xrock_gui_model {
 
+  // database models added to the palette per catalog timer tick
+  static const size_t catalogChunkSize = 64;
+
   ModelWidget::ModelWidget(mars::cfg_manager::CFGManagerInterface *cfg,
                            bagel_gui::BagelGui *bagelGui, ModelLib *mainLib,
                            QWidget *parent) :
@@ -38,6 +56,17 @@ namespace xrock_gui_model {
     size_t i=0;
     modelPath = cfg->getOrCreateProperty("XRockGUI", "modelPath", ".", this).sValue;
     bagelGui->setLoadPath(modelPath);
+    // autosave interval in seconds, 0 disables the autosave
+    int autosaveInterval = cfg->getOrCreateProperty("XRockGUI", "autosaveInterval", 0, this).iValue;
+    autosaveTimer = 0;
+    autosavedModel = pendingModel = NULL;
+    autosavedChanges = pendingChanges = 0;
+    loading = false;
+    if(autosaveInterval > 0) {
+      autosaveTimer = startTimer(autosaveInterval*1000);
+    }
+    catalogTimer = 0;
+    watchCatalog();
 
     QLabel *l = new QLabel("name");
     layout->addWidget(l, i, 0);
@@ -169,6 +198,106 @@ namespace xrock_gui_model {
   }
 
   ModelWidget::~ModelWidget(void) {
+    if(autosaveJob.valid()) {
+      autosaveJob.wait();
+    }
+  }
+
+  void ModelWidget::timerEvent(QTimerEvent *event) {
+    // the graph is incomplete while a model is loaded
+    if(loading) return;
+    if(event->timerId() == autosaveTimer) {
+      autosave();
+    }
+    else if(event->timerId() == catalogTimer) {
+      if(Model::pollDBNodeInfos(catalogChunkSize)) {
+        bagelGui->updateNodeTypes();
+      }
+      if(!Model::isLoadingDBNodeInfos()) {
+        killTimer(catalogTimer);
+        catalogTimer = 0;
+      }
+    }
+  }
+
+  void ModelWidget::watchCatalog() {
+    if(!catalogTimer && Model::isLoadingDBNodeInfos()) {
+      catalogTimer = startTimer(50);
+    }
+  }
+
+  void ModelWidget::autosave() {
+    // the previous autosave is still written
+    if(autosaveJob.valid()) {
+      if(autosaveJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+      }
+      if(autosaveJob.get()) {
+        autosavedModel = pendingModel;
+        autosavedChanges = pendingChanges;
+      }
+    }
+    Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+    if(loading || !model || !model->isDirty()) return;
+    if(model == autosavedModel && model->getChangeCount() == autosavedChanges) {
+      return;
+    }
+    PhaseTimer timer("autosave", true);
+    std::string file = autosaveFile(currentFile);
+
+    // the gui owns the node maps, so the snapshot is taken here; the
+    // fragments of unchanged nodes are reused and the map is moved into
+    // the job which does the encoding
+    updateCurrentLayout();
+    std::shared_ptr<ConfigMap> snapshot = std::make_shared<ConfigMap>();
+    createMap(snapshot.get(), false);
+    pendingModel = model;
+    pendingChanges = model->getChangeCount();
+    // the binary writer replaces the file only once it is complete
+    autosaveJob = std::async(std::launch::async, [snapshot, file]() {
+        if(!ModelFile::save(*snapshot, file)) {
+          fprintf(stderr, "ERROR: autosave to %s failed\n", file.c_str());
+          return false;
+        }
+        return true;
+      });
+  }
+
+  std::string ModelWidget::autosaveFile(const std::string &file) {
+    std::string name = file;
+    std::string path = modelPath;
+    if(!name.empty()) {
+      path = mars::utils::getPathOfFile(file);
+      mars::utils::removeFilenamePrefix(&name);
+      mars::utils::removeFilenameSuffix(&name);
+    }
+    else {
+      name << localMap["name"];
+      if(name.empty()) {
+        name = "unnamed";
+      }
+    }
+    name = mars::utils::replaceString(name, "/", "_");
+    name = mars::utils::replaceString(name, ":", "_");
+    return mars::utils::pathJoin(path, "." + name + ".autosave" + ModelFile::binarySuffix);
+  }
+
+  void ModelWidget::removeAutosave() {
+    if(autosaveJob.valid()) {
+      autosaveJob.wait();
+      autosaveJob.get();
+    }
+    std::string file = autosaveFile(currentFile);
+    if(mars::utils::pathExists(file)) {
+      remove(file.c_str());
+    }
+  }
+
+  void ModelWidget::clearDirty() {
+    Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+    if(model) {
+      model->clearDirty();
+    }
   }
 
   void ModelWidget::deinit(void) {
@@ -265,10 +394,15 @@ namespace xrock_gui_model {
   }
 
   void ModelWidget::storeModel() {
+    PhaseTimer timer("storeModel", true);
     updateCurrentLayout();
     ConfigMap map;
     createMap(&map);
     bool success = mainLib->db->storeModel(map);
+    if(success) {
+      clearDirty();
+      removeAutosave();
+    }
     bagel_gui::BagelModel *model = dynamic_cast<bagel_gui::BagelModel*>(bagelGui->getCurrentModel());
     if(model) {
       // try to save bagel graph
@@ -293,23 +427,212 @@ namespace xrock_gui_model {
     QString fileName = QFileDialog::getOpenFileName(NULL,
                                                     QObject::tr("Select Model"),
                                                     bagelGui->getLoadPath().c_str(),
-                                                    QObject::tr("Model Files (*.yml)"),0);
+                                                    QObject::tr("Model Files (*.yml *.xmb)"),0);
     loadModel(fileName.toStdString());
   }
 
+  static bool isNewerFile(const std::string &file, const std::string &other) {
+    struct stat st, otherSt;
+    if(stat(file.c_str(), &st) != 0) return false;
+    if(stat(other.c_str(), &otherSt) != 0) return true;
+    return st.st_mtime > otherSt.st_mtime;
+  }
+
   void ModelWidget::loadModel(const std::string &file) {
+    PhaseTimer timer("openModel", true);
+    // a streamed load processes events
+    if(loading) return;
     if(mars::utils::pathExists(file)) {
+      // an autosave newer than the file holds changes that were not saved
+      std::string source = file;
+      std::string autosaved = autosaveFile(file);
+      if(isNewerFile(autosaved, file) &&
+         QMessageBox::question(this, "Load Model",
+                               "The model has unsaved changes from an autosave. Recover them?",
+                               QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
+        source = autosaved;
+      }
       modelPath = mars::utils::getPathOfFile(file);
       if(modelPath[modelPath.size()-1] != '/') modelPath.append("/");
 
-      ConfigMap map = ConfigMap::fromYamlFile(file, true);
+      auto load = [&](const std::string &path) {
+        if(!ModelFile::isBinary(path) && loadModelStreamed(path)) return true;
+        ConfigMap map;
+        if(!ModelFile::load(path, map)) return false;
+        ConfigMapHelper::unpackData(map);
+        map["modelPath"] = modelPath;
+        loadModel(map);
+        return true;
+      };
+      if(!load(source)) {
+        if(source == file) return;
+        QMessageBox message;
+        message.setText("The autosave could not be read, the saved model is loaded instead.");
+        message.exec();
+        source = file;
+        if(!load(source)) return;
+      }
+      currentFile = file;
+      Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+      if(model && source != file) {
+        model->setChanged();
+      }
+    }
+  }
+
+  // configmaps writes the keys of the top level map in order; the view
+  // can only be created while streaming if name and domain come first
+  static bool hasHeaderBeforeGraph(std::istream &in) {
+    bool name = false, domain = false;
+    std::string line;
+    while(std::getline(in, line)) {
+      if(line.compare(0, 5, "name:") == 0) name = true;
+      else if(line.compare(0, 7, "domain:") == 0) domain = true;
+      else if(line.compare(0, 9, "versions:") == 0) break;
+    }
+    in.clear();
+    in.seekg(0, std::ios::beg);
+    return name && domain;
+  }
+
+  bool ModelWidget::loadModelStreamed(const std::string &file) {
+    PhaseTimer timer("streamModel");
+    std::ifstream in(file.c_str());
+    if(!in.good()) return false;
+    // other files are loaded in one piece
+    if(!hasHeaderBeforeGraph(in)) return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    // timers and a second load are blocked until the graph is complete,
+    // the events processed in between are restricted to repaints
+    struct LoadingGuard {
+      bool &flag;
+      explicit LoadingGuard(bool &flag) : flag(flag) {flag = true;}
+      ~LoadingGuard() {flag = false;}
+    } guard(loading);
+    QProgressDialog progress(tr("Loading model ..."), QString(), 0, 1000, this);
+    progress.setWindowModality(Qt::ApplicationModal);
+    progress.setMinimumDuration(500);
+
+    // the view is created with the first node or edge
+    ConfigMap header;
+    header["modelPath"] = modelPath;
+    bool started = false, fallback = false;
+    StreamedGraph streamed;
+    streamed.model = NULL;
+    // deployments are created when they are read, the other nodes once the
+    // node list is complete; this is the order of loadGraph()
+    ConfigMap pending;
+    size_t numItems = 0;
+    const size_t chunkSize = 200;
+
+    auto start = [&]() {
+      if(started || fallback) return;
+      if(!header.hasKey("name") || !header.hasKey("domain")) {
+        fallback = true;
+        return;
+      }
+      started = true;
+      beginModel(header);
+      streamed.model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+      if(streamed.model) {
+        streamed.model->beginBatch();
+      }
+    };
+    auto updateProgress = [&]() {
+      std::streamoff pos = in.tellg();
+      if(size > 0 && pos > 0) {
+        progress.setValue((int)(pos*1000/size));
+      }
+      QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    };
+    auto addNode = [&](ConfigMap &node) {
+      std::string domain = createNode(node);
+      streamed.nodes.push_back(std::make_pair(node["name"].getString(), domain));
+    };
+    auto flushNodes = [&]() {
+      if(!pending.hasKey("nodes")) return;
+      prefetchTypes(pending);
+      size_t n = 0;
+      for(auto &it: pending["nodes"]) {
+        addNode(it);
+        if(++n % chunkSize == 0) {
+          QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+        }
+      }
+      // the parsed nodes are not needed anymore
+      pending.clear();
+    };
+
+    auto onScalar = [&](const std::string &key, const std::string &value) {
+      if(!started) header[key] = value;
+    };
+    auto onItem = [&](const std::string &list, const std::string &item) {
+      start();
+      if(!started) return;
+      if(++numItems % chunkSize == 0) {
+        updateProgress();
+      }
+      ConfigMap map = ConfigMap::fromYamlString(item);
+      if(list == "edges") {
+        // the edges are added once the nodes are configured
+        flushNodes();
+        streamed.edges.push_back(map);
+        return;
+      }
+      if(map["model"]["name"] == "software::Deployment") {
+        addNode(map);
+      }
+      else {
+        pending["nodes"].push_back(map);
+      }
+    };
+
+    std::string rest;
+    bool ok = ModelStreamReader::read(in, onItem, onScalar, &rest);
+    if(started && !ok) {
+      // the file is broken, the partial graph is not kept
+      if(streamed.model) {
+        streamed.model->endBatch();
+      }
+      for(auto &it: streamed.nodes) {
+        bagelGui->removeNode(it.first);
+      }
+      clear();
+      progress.close();
+      QMessageBox message;
+      message.setText(QString::fromStdString("The model could not be read: " + file));
+      message.exec();
+      return true;
+    }
+    if(!ok || fallback) {
+      return false;
+    }
+    if(!started) {
+      // no graph in the file
+      ConfigMap map = ConfigMap::fromYamlString(rest);
       map["modelPath"] = modelPath;
       loadModel(map);
-    }
+      return true;
+    }
+    flushNodes();
+    ConfigMap map = ConfigMap::fromYamlString(rest);
+    map["modelPath"] = modelPath;
+    loadModelInfo(map, &streamed);
+    progress.setValue(1000);
+    return true;
   }
 
   void ModelWidget::loadModel(ConfigMap &map) {
-    ConfigMap myMap;
+    PhaseTimer timer("loadModel", true);
+    beginModel(map);
+    loadModelInfo(map, NULL);
+  }
+
+  void ModelWidget::beginModel(ConfigMap &map) {
+    currentFile.clear();
     if(map.hasKey("modelPath")) {
       modelPath << map["modelPath"];
     }
@@ -318,13 +641,16 @@ namespace xrock_gui_model {
     }
     bagelGui->setLoadPath(modelPath);
     //fprintf(stderr, "set load path to: %s\n", modelPath.c_str());
-    std::string domainData = mars::utils::tolower(map["domain"]) + "Data";
 
     // create view clears this widget
     bagelGui->createView("xrock", map["name"]);
     bagelGui->setSmoothLineMode();
+  }
 
-    myMap["domain"] = mars::utils::tolower(map["domain"]).c_str();
+  void ModelWidget::loadModelInfo(ConfigMap &map, StreamedGraph *streamed) {
+    ConfigMap myMap;
+    std::string domainData = StringTable::global().tolower(map["domain"]) + "Data";
+    myMap["domain"] = StringTable::global().tolower(map["domain"]).c_str();
     myMap["name"]   = map["name"];
     myMap["type"]   = map["type"];
     myMap["versions"][0]["name"] = map["versions"][0]["name"];
@@ -338,7 +664,7 @@ namespace xrock_gui_model {
        map["versions"][0][domainData].hasKey("data"))
     {
       myMap["versions"][0][domainData] = map["versions"][0][domainData];
-      myMap["versions"][0][domainData]["data"] = ConfigMap::fromYamlString(map["versions"][0][domainData]["data"]);
+      myMap["versions"][0][domainData]["data"] = ConfigMapHelper::getData(map["versions"][0][domainData]["data"]);
     }
 
     if(map["versions"][0].hasKey("maturity")) {
@@ -362,11 +688,33 @@ namespace xrock_gui_model {
 
     if(map["versions"][0].hasKey("defaultConfiguration")) {
       if(map["versions"][0]["defaultConfiguration"].hasKey("data")) {
-        myMap["versions"][0]["defaultConfiguration"]["data"] = ConfigMap::fromYamlString(map["versions"][0]["defaultConfiguration"]["data"]);
+        myMap["versions"][0]["defaultConfiguration"]["data"] = ConfigMapHelper::getData(map["versions"][0]["defaultConfiguration"]["data"]);
       }
     }
 
-    if(map["versions"][0].hasKey("components")) {
+    if(streamed) {
+      // the nodes and edges are already added, the configuration and the
+      // exported interfaces are applied now; the index points into cMap
+      ConfigMap empty;
+      ConfigMap &cMap = (map["versions"][0].hasKey("components") ?
+                         (ConfigMap&)map["versions"][0]["components"] : empty);
+      GraphIndex index;
+      indexGraph(cMap, index);
+      for(auto &it: streamed->nodes) {
+        configureNode(it.first, it.second, index);
+      }
+      for(auto &it: streamed->edges) {
+        loadEdge(it);
+      }
+      streamed->edges.clear();
+      if(streamed->model) {
+        streamed->model->endBatch();
+      }
+      if(!streamed->nodes.empty()) {
+        interfaces->setReadOnly(true);
+      }
+    }
+    else if(map["versions"][0].hasKey("components")) {
       //fprintf(stderr, "model graph:\n%s\n", map["versions"][0]["components"].c_str());
       ConfigMap &cMap = map["versions"][0]["components"];
       if(cMap.hasKey("nodes")) {
@@ -393,6 +741,7 @@ namespace xrock_gui_model {
             layouts->setCurrentItem(layouts->item(layouts->count()-1));
             currentLayout = defLayout;
             //bagelGui->loadLayout(currentLayout + ".yml");
+            PhaseTimer timer("applyLayout");
             bagelGui->applyLayout(it.second);
           }
         }
@@ -410,9 +759,11 @@ namespace xrock_gui_model {
     setModelInfo(myMap);
     updateModelInfo();
     handleEditionLayout();
+    clearDirty();
   }
 
   void ModelWidget::handleEditionLayout() {
+    PhaseTimer timer("handleEditionLayout");
     // if possible set the layout depending on the edition
     if(!edition.empty()) {
       bool found = false;
@@ -453,56 +804,167 @@ namespace xrock_gui_model {
    *       - how to handle visual properties
    */
   void ModelWidget::loadGraph(ConfigMap &map) {
+    PhaseTimer timer("loadGraph");
     //ConfigMap map = ConfigMap::fromYamlFile(file);
-    ConfigMap config;
+    GraphIndex index;
+    indexGraph(map, index);
 
-    if(map.hasKey("configuration")) {
-      config = map["configuration"];
+    Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+    if(model) {
+      model->beginBatch();
     }
-
     // create view; set model
     if(map.hasKey("nodes")) {
+      prefetchTypes(map);
       ConfigVector::iterator it = map["nodes"].begin();
-      ConfigVector pending;
+      // deployments are loaded first; the other nodes are only referenced
+      std::vector<ConfigMap*> pending;
       for(; it!=map["nodes"].end(); ++it) {
         if((*it)["model"]["name"] == "software::Deployment") {
-          loadNode((*it), config);
+          loadNode((*it), index);
         }
         else {
-          pending.push_back(*it);
+          ConfigMap &node = *it;
+          pending.push_back(&node);
         }
       }
-      for(it=pending.begin(); it!=pending.end(); ++it) {
-        loadNode((*it), config);
+      for(auto node: pending) {
+        loadNode(*node, index);
       }
     }
 
     if(map.hasKey("edges")) {
       ConfigVector::iterator it = map["edges"].begin();
       for(; it!=map["edges"].end(); ++it) {
-        ConfigMap edge;
-        std::string name = (*it)["from"]["name"];
-        edge["fromNode"] = name;
-        edge["fromNodeOutput"] = (*it)["from"]["interface"];
-
-        name << (*it)["to"]["name"];
-        edge["toNode"] = name;
-        edge["toNodeInput"] = (*it)["to"]["interface"];;
-
-        edge["name"] = (*it)["name"];
-        if(it->hasKey("data")) {
-          edge.append(ConfigMap::fromYamlString((*it)["data"].getString()));
+        loadEdge(*it);
+      }
+    }
+    if(model) {
+      model->endBatch();
+    }
+  }
+
+  void ModelWidget::indexGraph(ConfigMap &map, GraphIndex &index) {
+    // index the configuration and exported interfaces by name; the first
+    // entry of a name is used; the index points into map
+    if(map.hasKey("configuration")) {
+      ConfigMap &config = map["configuration"];
+      const char *configLists[2] = {"nodes", "edges"};
+      for(int l=0; l<2; ++l) {
+        if(!config.hasKey(configLists[l])) continue;
+        std::unordered_map<std::string, ConfigItem*> &target = l ? index.edgeConfig : index.nodeConfig;
+        for(auto &it: config[configLists[l]]) {
+          target.insert(std::make_pair(it["name"].getString(), &it));
+        }
+      }
+    }
+    if(interfaceMap.hasKey("interfaces")) {
+      for(auto &it: interfaceMap["interfaces"]) {
+        if(!it.hasKey("linkToNode")) continue;
+        std::string key = GraphIndex::interfaceKey(it["linkToNode"], it["linkToInterface"]);
+        std::string direction = it["direction"];
+        if(direction == "INCOMING" || direction == "BIDIRECTIONAL") {
+          index.inputInterfaces.insert(std::make_pair(key, &it));
+        }
+        else if(direction == "OUTGOING") {
+          index.outputInterfaces.insert(std::make_pair(key, &it));
         }
-        edge["smooth"] = true;
-        bagelGui->addEdge(edge);
       }
     }
   }
 
-  void ModelWidget::loadNode(ConfigMap &node, ConfigMap &config) {
-    std::string domain = mars::utils::tolower(node["model"]["domain"]);
+  void ModelWidget::loadEdge(ConfigMap &item) {
+    ConfigMap edge;
+    std::string name = item["from"]["name"];
+    edge["fromNode"] = name;
+    edge["fromNodeOutput"] = item["from"]["interface"];
+
+    name << item["to"]["name"];
+    edge["toNode"] = name;
+    edge["toNodeInput"] = item["to"]["interface"];;
+
+    edge["name"] = item["name"];
+    if(item.hasKey("data")) {
+      edge.append(ConfigMapHelper::getData(item["data"]));
+    }
+    edge["smooth"] = true;
+    bagelGui->addEdge(edge);
+  }
+
+  void ModelWidget::prefetchTypes(ConfigMap &map) {
+    PhaseTimer timer("prefetchTypes");
+    Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+    if(!model) return;
+    // the distinct types in the order of their first use, as loadType()
+    // would see them
+    std::vector<DBInterface::ModelRequest> types;
+    std::unordered_set<std::string> known;
+    for(auto &it: map["nodes"]) {
+      DBInterface::ModelRequest request;
+      request.domain = StringTable::global().tolower(it["model"]["domain"]);
+      request.model = it["model"]["name"].getString();
+      if(it["model"].hasKey("version")) {
+        request.version << it["model"]["version"];
+      }
+      request.limit = !request.version.empty();
+      if(request.domain == "software" && request.model == "Deployment") continue;
+      if(known.insert(request.domain+'\n'+request.model+'\n'+request.version).second) {
+        types.push_back(request);
+      }
+    }
+
+    // only the types used here are awaited from the catalog bootstrap
+    std::vector<std::string> softwareTypes;
+    for(auto &it: types) {
+      if(it.domain == "software") softwareTypes.push_back(it.model);
+    }
+    bool changed = Model::waitForDBNodeInfos(softwareTypes);
+
+    // unknown types are added with the first version that is used
+    std::vector<DBInterface::ModelRequest> requests;
+    known.clear();
+    for(auto &it: types) {
+      if(!model->hasNodeInfo(it.model) && known.insert(it.model).second) {
+        requests.push_back(it);
+      }
+    }
+    changed |= !requests.empty();
+    std::vector<ConfigMap> models = mainLib->db->requestModels(requests);
+    for(auto &it: models) {
+      model->addNodeInfo(it);
+    }
+
+    // other versions of known types are added as <type>::<version>
+    requests.clear();
+    known.clear();
+    for(auto &it: types) {
+      if(it.version.empty() || !model->hasNodeInfo(it.model)) continue;
+      std::string type = it.model + "::" + it.version;
+      if(model->hasNodeInfo(type) || !known.insert(type).second) continue;
+      if(model->getNodeInfoVersion(it.model) != it.version) {
+        requests.push_back(it);
+      }
+    }
+    changed |= !requests.empty();
+    models = mainLib->db->requestModels(requests);
+    for(size_t i=0; i<models.size(); ++i) {
+      model->addNodeInfo(models[i], requests[i].version);
+    }
+
+    if(changed) {
+      bagelGui->updateNodeTypes();
+    }
+  }
+
+  void ModelWidget::loadNode(ConfigMap &node, const GraphIndex &index) {
+    PhaseTimer timer("loadNode");
+    std::string domain = createNode(node);
+    configureNode(node["name"], domain, index);
+  }
+
+  std::string ModelWidget::createNode(ConfigMap &node) {
+    std::string domain = StringTable::global().tolower(node["model"]["domain"]);
     std::string name = node["name"];
-    std::string origName = node["name"];
     std::string modelName = node["model"]["name"];
     std::string modelVersion;
     if(node["model"].hasKey("version")) {
@@ -521,35 +983,35 @@ namespace xrock_gui_model {
         }
       }
     }
-    bagelGui->addNode(type, name);
+    {
+      PhaseTimer timer("addNode");
+      bagelGui->addNode(type, name);
+    }
+    return domain;
+  }
 
+  void ModelWidget::configureNode(const std::string &name,
+                                  const std::string &domain,
+                                  const GraphIndex &index) {
+    PhaseTimer timer("configureNode");
+    const std::string &origName = name;
     ConfigMap data;
     // get node config
-    if(config.hasKey("nodes")) {
-      ConfigVector::iterator itConf = config["nodes"].begin();
-      for(; itConf != config["nodes"].end(); ++itConf) {
-        std::string model = (*itConf)["name"];
-        if(model == name) {
-          if(itConf->hasKey("data")) {
-            data["configuration"] = ConfigMap::fromYamlString((*itConf)["data"].getString());
-          }
-          if(itConf->hasKey("submodel")) {
-            ConfigMapHelper::unpackSubmodel(data, (*itConf)["submodel"]);
-          }
-          break;
-        }
+    std::unordered_map<std::string, ConfigItem*>::const_iterator itConf;
+    itConf = index.nodeConfig.find(name);
+    if(itConf != index.nodeConfig.end()) {
+      ConfigItem &conf = *(itConf->second);
+      if(conf.hasKey("data")) {
+        data["configuration"] = ConfigMapHelper::getData(conf["data"]);
       }
-    }
-    if(config.hasKey("edges")) {
-      ConfigVector::iterator itConf = config["edges"].begin();
-      for(; itConf != config["edges"].end(); ++itConf) {
-        std::string model = (*itConf)["name"];
-        if(model == name) {
-          data["edge_submodel"] = *itConf;
-          break;
-        }
+      if(conf.hasKey("submodel")) {
+        ConfigMapHelper::unpackSubmodel(data, conf["submodel"]);
       }
     }
+    itConf = index.edgeConfig.find(name);
+    if(itConf != index.edgeConfig.end()) {
+      data["edge_submodel"] = *(itConf->second);
+    }
     // todo: handle name clashes
     const ConfigMap *nodeMap_ = bagelGui->getNodeMap(name);
     if(!nodeMap_) {
@@ -573,46 +1035,34 @@ namespace xrock_gui_model {
       nodeMap[domain+"Data"]["data"].appendMap(data);
       updateMap = true;
     }
+    std::unordered_map<std::string, ConfigItem*>::const_iterator itInterface;
     ConfigVector::iterator itNodeMap = nodeMap["inputs"].begin();
     for(;itNodeMap != nodeMap["inputs"].end(); ++itNodeMap) {
       // todo: handle origname correctly due to domain
       //std::string iname = origName + ":" + (std::string)(*itNodeMap)["name"];
-      ConfigVector::iterator it2 = interfaceMap["interfaces"].begin();
-      for(; it2 != interfaceMap["interfaces"].end(); ++it2) {
-        if(it2->hasKey("linkToNode") &&
-           (*it2)["linkToNode"] == origName &&
-           (*it2)["linkToInterface"] == (std::string)(*itNodeMap)["name"] &&
-           ((*it2)["direction"] == "INCOMING" || (*it2)["direction"] == "BIDIRECTIONAL"))
-        {
-          (*itNodeMap)["interface"] = 1;
-          (*itNodeMap)["interfaceExportName"] = (*it2)["name"];
-          if(it2->hasKey("data")) {
-            ConfigMap data = ConfigMap::fromYamlString((*it2)["data"]);
-            if(data.hasKey("initValue")) {
-              (*itNodeMap)["initValue"] = data["initValue"];
-            }
+      itInterface = index.inputInterfaces.find(GraphIndex::interfaceKey(origName, (*itNodeMap)["name"]));
+      if(itInterface != index.inputInterfaces.end()) {
+        ConfigItem &interface_ = *(itInterface->second);
+        (*itNodeMap)["interface"] = 1;
+        (*itNodeMap)["interfaceExportName"] = interface_["name"];
+        if(interface_.hasKey("data")) {
+          ConfigMap data = ConfigMapHelper::getData(interface_["data"]);
+          if(data.hasKey("initValue")) {
+            (*itNodeMap)["initValue"] = data["initValue"];
           }
-          updateMap = true;
-          break;
         }
+        updateMap = true;
       }
     }
     itNodeMap = nodeMap["outputs"].begin();
     for(;itNodeMap != nodeMap["outputs"].end(); ++itNodeMap) {
       // todo: handle origname correctly due to domain
       //std::string iname = origName + ":" + (std::string)(*itNodeMap)["name"];
-      ConfigVector::iterator it2 = interfaceMap["interfaces"].begin();
-      for(; it2 != interfaceMap["interfaces"].end(); ++it2) {
-        if(it2->hasKey("linkToNode") &&
-           (*it2)["linkToNode"] == origName &&
-           (*it2)["linkToInterface"] == (std::string)(*itNodeMap)["name"] &&
-           ((*it2)["direction"] == "OUTGOING"))
-        {
-          (*itNodeMap)["interface"] = 1;
-          (*itNodeMap)["interfaceExportName"] = (*it2)["name"];
-          updateMap = true;
-          break;
-        }
+      itInterface = index.outputInterfaces.find(GraphIndex::interfaceKey(origName, (*itNodeMap)["name"]));
+      if(itInterface != index.outputInterfaces.end()) {
+        (*itNodeMap)["interface"] = 1;
+        (*itNodeMap)["interfaceExportName"] = (*(itInterface->second))["name"];
+        updateMap = true;
       }
     }
 
@@ -668,6 +1118,7 @@ namespace xrock_gui_model {
   }
 
   void ModelWidget::saveModel() {
+    PhaseTimer timer("saveModel", true);
     std::string suggestion = name->text().toStdString();
     if(suggestion.size() > 0 and mars::utils::getFilenameSuffix(suggestion) == "") {
       suggestion += ".yml";
@@ -676,7 +1127,7 @@ namespace xrock_gui_model {
     QString fileName = QFileDialog::getSaveFileName(NULL,
                                                     QObject::tr("Select Model"),
                                                     suggestion.c_str(),
-                                                    QObject::tr("Model Files (*.yml)"));
+                                                    QObject::tr("Model Files (*.yml);;Binary Model Files (*.xmb)"));
     if(!fileName.isNull()) {
       std::string file = fileName.toStdString();
       modelPath = mars::utils::getPathOfFile(file);
@@ -684,12 +1135,22 @@ namespace xrock_gui_model {
       bagelGui->setLoadPath(modelPath);
       updateCurrentLayout();
       ConfigMap map;
-      createMap(&map);
-      map.toYamlFile(file);
+      createMap(&map, !ModelFile::isBinary(file));
+      if(ModelFile::save(map, file)) {
+        clearDirty();
+        removeAutosave();
+        currentFile = file;
+      }
+      else {
+        QMessageBox message;
+        message.setText(QString::fromStdString("The model could not be saved to: " + file));
+        message.exec();
+      }
     }
   }
 
-  void ModelWidget::createMap(ConfigMap *m) {
+  void ModelWidget::createMap(ConfigMap *m, bool pack) {
+    PhaseTimer timer("createMap", true);
     ignoreUpdate = true;
     ConfigMap &map = *m;
     map = localMap;
@@ -698,7 +1159,7 @@ namespace xrock_gui_model {
     map.erase("editable_interfaces");
     map.erase("interfaces");
     map.erase("graphFile");
-    std::string domainl = mars::utils::tolower(localMap["domain"]);
+    std::string domainl = StringTable::global().tolower(localMap["domain"]);
     map["domain"] = mars::utils::toupper(domainl);
     map["versions"][0]["date"] = QDateTime::currentDateTime().toString(Qt::ISODate).toStdString();
 
@@ -708,18 +1169,10 @@ namespace xrock_gui_model {
     if(!t.empty()) {
       map["versions"][0][domainData] = ConfigMap::fromYamlString(t);
     }
-    if(map["versions"][0].hasKey(domainData)) {
-      if(map["versions"][0][domainData].hasKey("data")) {
-        std::string dataMap = map["versions"][0][domainData]["data"].toYamlString();
-        ConfigMap &tmpMap = map["versions"][0][domainData];
-        tmpMap.erase("data");
-        map["versions"][0][domainData]["data"] = dataMap;
-      }
-    }
     ConfigMap components;
     ConfigMap interfaceMap;
     ConfigMap descriptionMap;
-    saveGraph(components, interfaceMap, descriptionMap, domainl);
+    saveGraph(components, interfaceMap, descriptionMap, domainl, pack);
     if(interfaceMap.hasKey("interfaces")) {
       map["versions"][0]["interfaces"] = interfaceMap["interfaces"];
       if(map["type"] == "bagel::subgraph") {
@@ -730,7 +1183,7 @@ namespace xrock_gui_model {
         merge["default"] = 0.0;
         ConfigMap inMap = localMap["versions"][0]["defaultConfiguration"]["data"]["interfaces"];
         localMap["versions"][0]["defaultConfiguration"]["data"]["interfaces"] = ConfigMap();
-        for(auto it: interfaceMap["interfaces"]) {
+        for(auto &it: interfaceMap["interfaces"]) {
           if(it["direction"] == "INCOMING") {
             // todo: check order or use dict instead of list
             std::string name = it["name"];
@@ -744,11 +1197,10 @@ namespace xrock_gui_model {
         }
       }
     }
-    // convert back to string
     if(localMap["versions"][0].hasKey("defaultConfiguration")) {
       ConfigMap &defMap = map["versions"][0]["defaultConfiguration"];
       defMap.erase("data");
-      defMap["data"] = localMap["versions"][0]["defaultConfiguration"]["data"].toYamlString();
+      defMap["data"] = localMap["versions"][0]["defaultConfiguration"]["data"];
     }
     if(components.hasKey("nodes")) {
       map["versions"][0]["components"] = components;
@@ -765,15 +1217,15 @@ namespace xrock_gui_model {
       }
     }
     ConfigMap dataMap;
+    bool updateMap = false;
     if(map["versions"][0].hasKey(domainData) &&
        map["versions"][0][domainData].hasKey("data")) {
-      dataMap = ConfigMap::fromYamlString(map["versions"][0][domainData]["data"]);
+      dataMap = ConfigMapHelper::getData(map["versions"][0][domainData]["data"]);
       if(dataMap.hasKey("gui")) {
         dataMap.erase("gui");
-        map["versions"][0][domainData]["data"] = dataMap.toYamlString();
+        updateMap = true;
       }
     }
-    bool updateMap = false;
     if(guiMap.hasKey("layouts")) {
       dataMap["gui"] = guiMap;
       updateMap = true;
@@ -783,14 +1235,15 @@ namespace xrock_gui_model {
       updateMap = true;
     }
     if(updateMap) {
-      map["versions"][0][domainData]["data"] = dataMap.toYamlString();
+      map["versions"][0][domainData]["data"] = dataMap;
     }
     ignoreUpdate = false;
   }
 
   void ModelWidget::saveGraph(ConfigMap &output, ConfigMap &interfaceMap,
                               ConfigMap &descriptionMap,
-                              const std::string &saveDomain) {
+                              const std::string &saveDomain, bool pack) {
+    PhaseTimer timer("saveGraph");
     ConfigMap map = bagelGui->createConfigMap();
     ConfigMap config;
     ConfigMap tmpInterfaces;
@@ -809,204 +1262,245 @@ namespace xrock_gui_model {
       return;
     }
     if(map.hasKey("descriptions")) {
-      for(auto it: map["descriptions"]) {
+      for(auto &it: map["descriptions"]) {
         descriptionMap["nodes"].push_back(it);
       }
     }
-    ConfigVector::iterator it = map["nodes"].begin();
-    for(; it!=map["nodes"].end(); ++it) {
-      std::string name = (*it)["name"];
-      std::string domain = mars::utils::tolower((*it)["domain"]);
-      ConfigMap nodeData, edgeData;
-      nodeData["name"] = name;
-      bool handleNodeConfig = false;
-      bool handleEdgeConfig = false;
-      for(auto it2: xrockConfigFilter) {
-        if(it->hasKey(it2)) {
-          (*it)[domain+"Data"]["data"]["configuration"]["xrock_config"][it2] = (*it)[it2];
+    InterfaceSet exported(interfaceMap);
+    Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
+    std::unordered_set<std::string> usedNodes;
+    for(auto &it: map["nodes"]) {
+      std::string name = it["name"];
+      unsigned long revision = model ? model->getNodeRevision(name) : 0;
+      NodeFragment tmpFragment;
+      NodeFragment *fragment = &tmpFragment;
+      // fragments are only cached for nodes known to the model
+      if(revision && usedNodes.insert(name).second) {
+        fragment = &nodeFragments[name];
+        if(fragment->revision != revision) {
+          createNodeFragment(it, *fragment);
+          fragment->revision = revision;
         }
       }
-      if(it->hasKey(domain+"Data") &&
-         (*it)[domain+"Data"].hasKey("data") &&
-         (*it)[domain+"Data"]["data"].hasKey("configuration")) {
-        nodeData["data"] = (*it)[domain+"Data"]["data"]["configuration"].toYamlString();
-        handleNodeConfig = true;
-      }
-      if(it->hasKey(domain+"Data") &&
-         (*it)[domain+"Data"].hasKey("data") &&
-         (*it)[domain+"Data"]["data"].hasKey("submodel")) {
-        ConfigMapHelper::packSubmodel(nodeData, (*it)[domain+"Data"]["data"]["submodel"]);
-        handleNodeConfig = true;
-      }
-      if((*it)["data"].hasKey("edge_submodel")) {
-        // todo: fix this
-        edgeData = (*it)["data"]["edge_submodel"];
-        handleEdgeConfig = true;
-      }
-      if(handleNodeConfig) {
-        config["nodes"].push_back(nodeData);
-      }
-      if(handleEdgeConfig) {
-        config["edges"].push_back(edgeData);
-      }
-      ConfigMap node;
-      node["name"] = name;//.substr(domain.size()+2);
-      node["model"]["domain"] = mars::utils::toupper(domain);
-      // remove domain from type
-      std::string type = (*it)["modelName"];
-      //type = type.substr(domain.size()+2);
-      //size_t pos = type.find_last_of(':');
-      if(it->hasKey("modelVersion")) {
-        node["model"]["version"] = (*it)["modelVersion"];
-      }
-      node["model"]["name"] = type;
-      output["nodes"].push_back(node);
-      if(it->hasKey("inputs")) {
-        ConfigVector::iterator it2 = (*it)["inputs"].begin();
-        for(;it2!=(*it)["inputs"].end(); ++it2) {
-          if(it2->hasKey("interface")) {
-            if((int)((*it2)["interface"]) == 1 || (int)((*it2)["interface"]) == 2) {
-              ConfigMap i, data;
-              std::string interfaceName;
-              if(it2->hasKey("interfaceExportName")) {
-                interfaceName << (*it2)["interfaceExportName"];
-              }
-              else {
-                interfaceName << node["name"];
-                interfaceName += ":" + (std::string)(*it2)["name"];
-              }
-              if(it2->hasKey("initValue")) {
-                data["initValue"] = (*it2)["initValue"];
-                i["data"] = data.toYamlString();
-              }
-              i["name"] =  interfaceName;
-              i["type"] = (*it2)["type"];
-              i["direction"] = mars::utils::toupper((*it2)["direction"]);
-              i["linkToNode"] = node["name"];
-              i["linkToInterface"] = (*it2)["name"];
-              i["domain"] = mars::utils::toupper((*it2)["domain"]);
-              if(interfaceMap.hasKey("interfaces")) {
-                ConfigVector::iterator it3 = interfaceMap["interfaces"].begin();
-                for(; it3!=interfaceMap["interfaces"].end(); ++it3) {
-                  if((*it3)["name"] == interfaceName && (*it3)["direction"] == (std::string)i["direction"]) {
-                    break;
-                  }
-                }
-                if(it3 == interfaceMap["interfaces"].end()) {
-                  interfaceMap["interfaces"].push_back(i);
-                }
-              }
-              else {
-                interfaceMap["interfaces"].push_back(i);
-              }
-            }
-          }
-        }
+      else {
+        createNodeFragment(it, tmpFragment);
       }
-      if(it->hasKey("outputs")) {
-        ConfigVector::iterator it2 = (*it)["outputs"].begin();
-        for(;it2!=(*it)["outputs"].end(); ++it2) {
-          if(it2->hasKey("interface")) {
-            if((int)((*it2)["interface"]) == 1 || (int)((*it2)["interface"]) == 2) {
-              //if((*it2)["direction"] == "bidirectional") continue;
-              ConfigMap i;
-              std::string interfaceName;
-              if(it2->hasKey("interfaceExportName")) {
-                interfaceName << (*it2)["interfaceExportName"];
-              }
-              else {
-                interfaceName << node["name"];
-                interfaceName += ":" + (std::string)(*it2)["name"];
-              }
-              if(interfaceMap.hasKey(interfaceName)) continue;
-              i["name"] =  interfaceName;
-              i["type"] = (*it2)["type"];
-              i["direction"] = mars::utils::toupper((*it2)["direction"]);
-              i["linkToNode"] = node["name"];
-              i["linkToInterface"] = (*it2)["name"];
-              i["domain"] = mars::utils::toupper((*it2)["domain"]);
-              if(interfaceMap.hasKey("interfaces")) {
-                ConfigVector::iterator it3 = interfaceMap["interfaces"].begin();
-                for(; it3!=interfaceMap["interfaces"].end(); ++it3) {
-                  if((*it3)["name"] == interfaceName && ((*it3)["direction"] == "OUTGOING" || (*it3)["direction"] == "BIDIRECTIONAL")) {
-                    break;
-                  }
-                }
-                if(it3 == interfaceMap["interfaces"].end()) {
-                  interfaceMap["interfaces"].push_back(i);
-                }
-              }
-              else {
-                interfaceMap["interfaces"].push_back(i);
-              }
-            }
+      if(fragment->hasConfig) {
+        if(!pack) {
+          config["nodes"].push_back(fragment->config);
+        }
+        else {
+          if(!fragment->packed) {
+            fragment->packedConfig = fragment->config;
+            ConfigMapHelper::packEntry(fragment->packedConfig);
+            fragment->packed = true;
           }
+          config["nodes"].push_back(fragment->packedConfig);
         }
       }
+      if(fragment->hasEdgeConfig) {
+        config["edges"].push_back(fragment->edgeConfig);
+      }
+      output["nodes"].push_back(fragment->node);
+      for(auto &i: fragment->inputs) {
+        exported.addInput(i);
+      }
+      for(auto &i: fragment->outputs) {
+        exported.addOutput(i);
+      }
+    }
+    // drop the fragments of removed nodes
+    for(auto it=nodeFragments.begin(); it!=nodeFragments.end(); ) {
+      if(usedNodes.count(it->first)) ++it;
+      else it = nodeFragments.erase(it);
     }
 
     if(tmpInterfaces.hasKey("i")) {
-      for(auto it : tmpInterfaces["i"]) {
+      for(auto &it : tmpInterfaces["i"]) {
         if(!it.hasKey("linkToNode")) {
-          ConfigVector::iterator it3 = interfaceMap["interfaces"].begin();
-          for(; it3!=interfaceMap["interfaces"].end(); ++it3) {
-            if((std::string)(*it3)["name"] == (std::string)it["name"]) {
-              break;
-            }
-          }
-          if(it3 == interfaceMap["interfaces"].end()) {
-            interfaceMap["interfaces"].push_back(it);
-          }
+          exported.addUnlinked(it);
         }
       }
     }
     output["configuration"] = config;
-    it = map["edges"].begin();
-    // todo: this filter can clash if the tags are used in edge data of graph model
-    std::map<std::string, bool> filter;
-    filter["fromNode"] = true;
-    filter["fromNodeOutput"] = true;
-    filter["sourceNode"] = true;
-    filter["toNode"] = true;
-    filter["toNodeInput"] = true;
-    filter["id"] = true;
-    filter["vertices"] = true;
-    filter["decoupleVertices"] = true;
-    for(; it!=map["edges"].end(); ++it) {
-      ConfigMap edge;
-      //todo: handle domain correctly
-      std::string fromName = (*it)["fromNode"];
-      std::string toName = (*it)["toNode"];
-      edge["from"]["name"] = fromName;
-      edge["from"]["interface"] = (*it)["fromNodeOutput"];
-      edge["from"]["domain"] = mars::utils::toupper((*it)["domain"]);
-      edge["to"]["name"] = toName;
-      edge["to"]["interface"] = (*it)["toNodeInput"];
-      edge["to"]["domain"] = mars::utils::toupper((*it)["domain"]);
-      ConfigMap edgeData;
-      ConfigMap::iterator it2 = it->beginMap();
-      for(; it2!=it->endMap(); ++it2) {
-        if(filter.find(it2->first) == filter.end()) {
-          edgeData[it2->first] = it2->second;
+    std::unordered_set<unsigned long> usedEdges;
+    for(auto &it: map["edges"]) {
+      // the type of the id atom depends on how the edge was created
+      unsigned long id = it.hasKey("id") ? strtoul(it["id"].toString().c_str(), NULL, 10) : 0;
+      unsigned long revision = model ? model->getEdgeRevision(id) : 0;
+      EdgeFragment tmpFragment;
+      EdgeFragment *fragment = &tmpFragment;
+      if(revision && usedEdges.insert(id).second) {
+        fragment = &edgeFragments[id];
+        if(fragment->revision != revision) {
+          createEdgeFragment(it, *fragment);
+          fragment->revision = revision;
         }
       }
-      if(edgeData.size() > 0) {
-        edge["data"] = edgeData.toYamlString();
+      else {
+        createEdgeFragment(it, tmpFragment);
       }
-      if(!it->hasKey("name")) {
-        edge["name"] = (*it)["id"].toString().c_str();
+      if(!pack) {
+        output["edges"].push_back(fragment->edge);
       }
       else {
-        edge["name"] = (*it)["name"].getString();
-      }
-      if(edge.hasKey("direction")) {
-        edge["direction"] = mars::utils::toupper(edge["direction"]);
+        if(!fragment->packed) {
+          fragment->packedEdge = fragment->edge;
+          ConfigMapHelper::packEntry(fragment->packedEdge);
+          fragment->packed = true;
+        }
+        output["edges"].push_back(fragment->packedEdge);
       }
-      output["edges"].push_back(edge);
+    }
+    for(auto it=edgeFragments.begin(); it!=edgeFragments.end(); ) {
+      if(usedEdges.count(it->first)) ++it;
+      else it = edgeFragments.erase(it);
     }
     //output.toYamlFile("da2.yml");
   }
 
+  void ModelWidget::createNodeFragment(ConfigMap &nodeMap, NodeFragment &fragment) {
+    std::string name = nodeMap["name"];
+    std::string domain = StringTable::global().tolower(nodeMap["domain"]);
+    ConfigMap nodeData, edgeData;
+    nodeData["name"] = name;
+    fragment.hasConfig = false;
+    fragment.hasEdgeConfig = false;
+    fragment.packed = false;
+    fragment.inputs.clear();
+    fragment.outputs.clear();
+    for(auto &it2: xrockConfigFilter) {
+      if(nodeMap.hasKey(it2)) {
+        nodeMap[domain+"Data"]["data"]["configuration"]["xrock_config"][it2] = nodeMap[it2];
+      }
+    }
+    if(nodeMap.hasKey(domain+"Data") &&
+       nodeMap[domain+"Data"].hasKey("data") &&
+       nodeMap[domain+"Data"]["data"].hasKey("configuration")) {
+      nodeData["data"] = nodeMap[domain+"Data"]["data"]["configuration"];
+      fragment.hasConfig = true;
+    }
+    if(nodeMap.hasKey(domain+"Data") &&
+       nodeMap[domain+"Data"].hasKey("data") &&
+       nodeMap[domain+"Data"]["data"].hasKey("submodel")) {
+      ConfigMapHelper::packSubmodel(nodeData, nodeMap[domain+"Data"]["data"]["submodel"]);
+      fragment.hasConfig = true;
+    }
+    if(nodeMap["data"].hasKey("edge_submodel")) {
+      // todo: fix this
+      edgeData = nodeMap["data"]["edge_submodel"];
+      fragment.hasEdgeConfig = true;
+    }
+    fragment.config = nodeData;
+    fragment.edgeConfig = edgeData;
+    ConfigMap node;
+    node["name"] = name;//.substr(domain.size()+2);
+    node["model"]["domain"] = mars::utils::toupper(domain);
+    // remove domain from type
+    std::string type = nodeMap["modelName"];
+    //type = type.substr(domain.size()+2);
+    //size_t pos = type.find_last_of(':');
+    if(nodeMap.hasKey("modelVersion")) {
+      node["model"]["version"] = nodeMap["modelVersion"];
+    }
+    node["model"]["name"] = type;
+    fragment.node = node;
+    if(nodeMap.hasKey("inputs")) {
+      ConfigVector::iterator it2 = nodeMap["inputs"].begin();
+      for(;it2!=nodeMap["inputs"].end(); ++it2) {
+        if(it2->hasKey("interface")) {
+          if((int)((*it2)["interface"]) == 1 || (int)((*it2)["interface"]) == 2) {
+            ConfigMap i, data;
+            std::string interfaceName;
+            if(it2->hasKey("interfaceExportName")) {
+              interfaceName << (*it2)["interfaceExportName"];
+            }
+            else {
+              interfaceName << node["name"];
+              interfaceName += ":" + (std::string)(*it2)["name"];
+            }
+            if(it2->hasKey("initValue")) {
+              data["initValue"] = (*it2)["initValue"];
+              i["data"] = data;
+            }
+            i["name"] =  interfaceName;
+            i["type"] = (*it2)["type"];
+            i["direction"] = mars::utils::toupper((*it2)["direction"]);
+            i["linkToNode"] = node["name"];
+            i["linkToInterface"] = (*it2)["name"];
+            i["domain"] = mars::utils::toupper((*it2)["domain"]);
+            fragment.inputs.push_back(i);
+          }
+        }
+      }
+    }
+    if(nodeMap.hasKey("outputs")) {
+      ConfigVector::iterator it2 = nodeMap["outputs"].begin();
+      for(;it2!=nodeMap["outputs"].end(); ++it2) {
+        if(it2->hasKey("interface")) {
+          if((int)((*it2)["interface"]) == 1 || (int)((*it2)["interface"]) == 2) {
+            //if((*it2)["direction"] == "bidirectional") continue;
+            ConfigMap i;
+            std::string interfaceName;
+            if(it2->hasKey("interfaceExportName")) {
+              interfaceName << (*it2)["interfaceExportName"];
+            }
+            else {
+              interfaceName << node["name"];
+              interfaceName += ":" + (std::string)(*it2)["name"];
+            }
+            i["name"] =  interfaceName;
+            i["type"] = (*it2)["type"];
+            i["direction"] = mars::utils::toupper((*it2)["direction"]);
+            i["linkToNode"] = node["name"];
+            i["linkToInterface"] = (*it2)["name"];
+            i["domain"] = mars::utils::toupper((*it2)["domain"]);
+            fragment.outputs.push_back(i);
+          }
+        }
+      }
+    }
+  }
+
+  void ModelWidget::createEdgeFragment(ConfigMap &edgeMap, EdgeFragment &fragment) {
+    // todo: this filter can clash if the tags are used in edge data of graph model
+    static const std::set<std::string> filter = {"fromNode", "fromNodeOutput",
+                                                 "sourceNode", "toNode",
+                                                 "toNodeInput", "id", "vertices",
+                                                 "decoupleVertices"};
+    ConfigMap edge;
+    //todo: handle domain correctly
+    std::string fromName = edgeMap["fromNode"];
+    std::string toName = edgeMap["toNode"];
+    edge["from"]["name"] = fromName;
+    edge["from"]["interface"] = edgeMap["fromNodeOutput"];
+    edge["from"]["domain"] = mars::utils::toupper(edgeMap["domain"]);
+    edge["to"]["name"] = toName;
+    edge["to"]["interface"] = edgeMap["toNodeInput"];
+    edge["to"]["domain"] = mars::utils::toupper(edgeMap["domain"]);
+    ConfigMap edgeData;
+    ConfigMap::iterator it2 = edgeMap.begin();
+    for(; it2!=edgeMap.end(); ++it2) {
+      if(filter.find(it2->first) == filter.end()) {
+        edgeData[it2->first] = it2->second;
+      }
+    }
+    if(edgeData.size() > 0) {
+      edge["data"] = edgeData;
+    }
+    if(!edgeMap.hasKey("name")) {
+      edge["name"] = edgeMap["id"].toString().c_str();
+    }
+    else {
+      edge["name"] = edgeMap["name"].getString();
+    }
+    if(edge.hasKey("direction")) {
+      edge["direction"] = mars::utils::toupper(edge["direction"]);
+    }
+    fragment.edge = edge;
+    fragment.packed = false;
+  }
+
   void ModelWidget::clear() {
     ignoreUpdate = true;
     edition = "";
@@ -1029,8 +1523,13 @@ namespace xrock_gui_model {
   void ModelWidget::loadType(const std::string &domain,
                              const std::string &name,
                              const std::string &version) {
+    PhaseTimer timer("loadType");
     if(domain == "software" && name == "Deployment") return;
     fprintf(stderr, "check type: %s %s %s\n", domain.c_str(), name.c_str(), version.c_str());
+    if(domain == "software" &&
+       Model::waitForDBNodeInfos(std::vector<std::string>(1, name))) {
+      bagelGui->updateNodeTypes();
+    }
     Model *model = dynamic_cast<Model*>(bagelGui->getCurrentModel());
     if (model) {
       ConfigMap modelMap, nodeInfo;
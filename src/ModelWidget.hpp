@@ -16,6 +16,9 @@
 #include <QTextEdit>
 #include <QCheckBox>
 
+#include <future>
+#include <unordered_map>
+
 namespace bagel_gui {
   class BagelGui;
 }
@@ -29,6 +32,7 @@ class ModelConfig {
 
 namespace xrock_gui_model {
   class ModelLib;
+  class Model;
 
   class ModelWidget : public mars::main_gui::BaseWidget {
     Q_OBJECT
@@ -38,20 +42,26 @@ namespace xrock_gui_model {
                 bagel_gui::BagelGui *bagelGui, ModelLib *mainLib,
                 QWidget *parent = 0);
     ~ModelWidget();
-    void createMap(configmaps::ConfigMap *m);
+    // with pack set the data fields of the graph are yaml strings
+    void createMap(configmaps::ConfigMap *m, bool pack=true);
     void loadModel(const std::string &file);
     void loadModel(configmaps::ConfigMap &m);
     void loadGraph(configmaps::ConfigMap &map);
     void saveGraph(configmaps::ConfigMap &output,
                    configmaps::ConfigMap &interfaceMap,
                    configmaps::ConfigMap &descriptionMap,
-                   const std::string &saveDomain);
+                   const std::string &saveDomain, bool pack=true);
     void clear();
     void setModelInfo(configmaps::ConfigMap &model);
     void deinit();
     void setEdition(const std::string &domain);
     void editLocalMap();
     void editDescription();
+    // adds the database node infos to the palette while they are loaded
+    void watchCatalog();
+
+  protected:
+    void timerEvent(QTimerEvent *event);
 
   public slots:
     void checkMechanics(int v);
@@ -89,9 +99,89 @@ namespace xrock_gui_model {
     std::vector<std::string> xrockConfigFilter;
     void handleEditionLayout();
     void updateCurrentLayout();
+    // writes the model next to the original file if the graph changed
+    // since the last save and the last autosave; the file is written in
+    // the background
+    void autosave();
+    // the autosave file of a model file, or of the model name if the
+    // model has no file
+    std::string autosaveFile(const std::string &file);
+    void removeAutosave();
+    void clearDirty();
+    int autosaveTimer;
+    // the file the model was loaded from or saved to
+    std::string currentFile;
+    // model and change count of the last successful and the running autosave
+    const Model *autosavedModel, *pendingModel;
+    unsigned long autosavedChanges, pendingChanges;
+    // set while a model is streamed into the view
+    bool loading;
+    // adds the node infos of the database to the palette while they load
+    int catalogTimer;
+    std::future<bool> autosaveJob;
+
+    // lookup tables build once per loadGraph() call; the entries point
+    // into the configuration of the graph and into interfaceMap
+    struct GraphIndex {
+      std::unordered_map<std::string, configmaps::ConfigItem*> nodeConfig, edgeConfig;
+      // exported interfaces by linkToNode and linkToInterface
+      std::unordered_map<std::string, configmaps::ConfigItem*> inputInterfaces, outputInterfaces;
+      static std::string interfaceKey(const std::string &node, const std::string &interface_) {
+        return node + '\n' + interface_;
+      }
+    };
+
+    // loads the node infos of all types used in the graph before the
+    // nodes are created, called from loadGraph()
+    void prefetchTypes(configmaps::ConfigMap &map);
+    // the parts of the saved graph generated from one node or edge; they
+    // are reused by saveGraph() until the item changes in the model
+    struct NodeFragment {
+      NodeFragment() : revision(0), hasConfig(false), hasEdgeConfig(false),
+                       packed(false) {}
+      unsigned long revision;
+      configmaps::ConfigMap node, config, packedConfig, edgeConfig;
+      bool hasConfig, hasEdgeConfig, packed;
+      // exported interfaces before duplicates are removed
+      std::vector<configmaps::ConfigMap> inputs, outputs;
+    };
+    struct EdgeFragment {
+      EdgeFragment() : revision(0), packed(false) {}
+      unsigned long revision;
+      configmaps::ConfigMap edge, packedEdge;
+      bool packed;
+    };
+    std::unordered_map<std::string, NodeFragment> nodeFragments;
+    std::unordered_map<unsigned long, EdgeFragment> edgeFragments;
+    void createNodeFragment(configmaps::ConfigMap &nodeMap, NodeFragment &fragment);
+    void createEdgeFragment(configmaps::ConfigMap &edgeMap, EdgeFragment &fragment);
+
+    // nodes created by loadModelStreamed(); they are configured once the
+    // rest of the file is read
+    struct StreamedGraph {
+      // the batch of the model is open until the nodes are configured
+      Model *model;
+      // name and domain of the nodes
+      std::vector<std::pair<std::string, std::string> > nodes;
+      // the edges are added after the nodes are configured
+      std::vector<configmaps::ConfigMap> edges;
+    };
+    // reads yaml files node by node; returns false if the file has to be
+    // loaded as a whole
+    bool loadModelStreamed(const std::string &file);
+    // sets the model path and creates the view
+    void beginModel(configmaps::ConfigMap &map);
+    void loadModelInfo(configmaps::ConfigMap &map, StreamedGraph *streamed);
+    void indexGraph(configmaps::ConfigMap &map, GraphIndex &index);
 
     // this function is called from loadGraph()
-    void loadNode(configmaps::ConfigMap &node, configmaps::ConfigMap &config);
+    void loadNode(configmaps::ConfigMap &node, const GraphIndex &index);
+    // adds the node and returns its domain
+    std::string createNode(configmaps::ConfigMap &node);
+    // applies the configuration and the exported interfaces of the graph
+    void configureNode(const std::string &name, const std::string &domain,
+                       const GraphIndex &index);
+    void loadEdge(configmaps::ConfigMap &item);
     configmaps::ConfigMap getDefaultConfig(const std::string &domain, const std::string &name, const std::string &version);
 
   };
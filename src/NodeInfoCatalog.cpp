@@ -0,0 +1,105 @@
+#include "NodeInfoCatalog.hpp"
+#include "BinaryConfigMap.hpp"
+
+#include <mars/utils/misc.h>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  // increase if the generation of the node infos changes
+  static const int cacheVersion = 2;
+
+  const ConfigMap& NodeInfoCatalog::parseData(const std::string &yaml) {
+    std::unordered_map<std::string, ConfigMap>::iterator it = data.find(yaml);
+    if(it != data.end()) {
+      return it->second;
+    }
+    ConfigMap map;
+    if(!yaml.empty()) {
+      try {
+        map = ConfigMap::fromYamlString(yaml);
+      } catch(...) {
+        fprintf(stderr, "ERROR: parsing yaml data\n");
+      }
+    }
+    return data.emplace(yaml, map).first->second;
+  }
+
+  NodeInfoCatalogCache::NodeInfoCatalogCache(const std::string &filename) :
+    filename(filename), modified(false) {
+    if(!filename.empty() && mars::utils::pathExists(filename)) {
+      if(!BinaryConfigMap::fromBinaryFile(filename, cache) ||
+         !cache.hasKey("version") || (int)cache["version"] != cacheVersion) {
+        fprintf(stderr, "ignore node info catalog cache: %s\n",
+                filename.c_str());
+        cache = ConfigMap();
+        modified = true;
+      }
+    }
+  }
+
+  bool NodeInfoCatalogCache::get(const std::string &source,
+                                 const std::string &fingerprint,
+                                 NodeInfoMap &infos) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!cache.hasKey("sources") || !cache["sources"].hasKey(source)) {
+      return false;
+    }
+    ConfigMap &entry = cache["sources"][source];
+    if(entry["fingerprint"].getString() != fingerprint) {
+      return false;
+    }
+    infos.clear();
+    if(entry.hasKey("infos")) {
+      for(auto &it: entry["infos"]) {
+        osg_graph_viz::NodeInfo info;
+        info.type = it["type"].getString();
+        info.numInputs = it["numInputs"];
+        info.numOutputs = it["numOutputs"];
+        info.map = it["map"];
+        infos[info.type] = info;
+      }
+    }
+    used["sources"][source] = entry;
+    return true;
+  }
+
+  void NodeInfoCatalogCache::set(const std::string &source,
+                                 const std::string &fingerprint,
+                                 const NodeInfoMap &infos) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ConfigMap entry;
+    entry["fingerprint"] = fingerprint;
+    entry["infos"] = ConfigVector();
+    for(auto &it: infos) {
+      ConfigMap info;
+      info["type"] = it.second.type;
+      info["numInputs"] = it.second.numInputs;
+      info["numOutputs"] = it.second.numOutputs;
+      info["map"] = it.second.map;
+      entry["infos"].push_back(info);
+    }
+    used["sources"][source] = entry;
+    modified = true;
+  }
+
+  void NodeInfoCatalogCache::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(filename.empty()) return;
+    // sources which were not requested anymore are dropped
+    if(cache.hasKey("sources") &&
+       (!used.hasKey("sources") ||
+        cache["sources"].size() != used["sources"].size())) {
+      modified = true;
+    }
+    if(!modified) return;
+    used["version"] = cacheVersion;
+    if(!BinaryConfigMap::toBinaryFile(used, filename)) {
+      fprintf(stderr, "could not write node info catalog cache: %s\n",
+              filename.c_str());
+    }
+    modified = false;
+  }
+
+} // end of namespace xrock_gui_model
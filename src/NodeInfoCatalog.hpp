@@ -0,0 +1,72 @@
+/**
+ * \file NodeInfoCatalog.hpp
+ * \brief The node infos known to a model and their on-disk cache
+ **/
+
+#ifndef XROCK_GUI_MODEL_NODE_INFO_CATALOG_HPP
+#define XROCK_GUI_MODEL_NODE_INFO_CATALOG_HPP
+
+#include <configmaps/ConfigMap.hpp>
+#include <osg_graph_viz/Node.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xrock_gui_model {
+
+  typedef std::map<std::string, osg_graph_viz::NodeInfo> NodeInfoMap;
+
+  /**
+   * The node infos are shared between a model and its clones. The infos
+   * of a catalog are never modified while it is shared; it is copied on
+   * the first modification instead (see Model::editNodeInfos()).
+   *
+   * The data fields of the infos are kept as yaml strings and are only
+   * parsed once a node of the type is created (see Model::expandData()).
+   * The parsed data is memoized in the catalog, so parseData() changes a
+   * shared catalog; it must only be called from the gui thread.
+   */
+  struct NodeInfoCatalog {
+    NodeInfoCatalog() : revision(0) {}
+    NodeInfoMap infos;
+    unsigned long revision;
+
+    // returns the parsed yaml, every distinct string is parsed only once;
+    // gui thread only
+    const configmaps::ConfigMap& parseData(const std::string &yaml);
+
+  private:
+    std::unordered_map<std::string, configmaps::ConfigMap> data;
+  };
+
+  /**
+   * Stores the node infos generated from each source (a definition file
+   * or the database) together with a fingerprint of the source. On the
+   * next start only the sources with a changed fingerprint have to be
+   * loaded again. The database source is looked up by the catalog
+   * bootstrap thread, thus the access is locked.
+   */
+  class NodeInfoCatalogCache {
+  public:
+    NodeInfoCatalogCache(const std::string &filename);
+
+    // returns false if the source is unknown or its fingerprint changed
+    bool get(const std::string &source, const std::string &fingerprint,
+             NodeInfoMap &infos);
+    void set(const std::string &source, const std::string &fingerprint,
+             const NodeInfoMap &infos);
+    // writes the sources used since construction, the others are dropped
+    void save();
+
+  private:
+    std::string filename;
+    std::mutex mutex;
+    configmaps::ConfigMap cache, used;
+    bool modified;
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_NODE_INFO_CATALOG_HPP
@@ -0,0 +1,77 @@
+#include "NodeInfoLoader.hpp"
+#include "ParallelFor.hpp"
+
+#include <mars/utils/misc.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstdio>
+
+using namespace configmaps;
+
+namespace xrock_gui_model {
+
+  void NodeInfoLoader::collectFiles(std::string path,
+                                    std::vector<FileEntry> &files) {
+    if(path[path.size()-1] != '/') {
+      path += "/";
+    }
+    DIR *dir;
+    struct dirent *ent;
+    if ((dir = opendir (path.c_str())) != NULL) {
+      // go through all entities
+      while ((ent = readdir (dir)) != NULL) {
+        std::string file = ent->d_name;
+
+        if (file.find(".yml", file.size() - 4, 4) != std::string::npos) {
+          FileEntry entry;
+          entry.path = path + file;
+          entry.mtime = entry.mtimeNs = entry.size = 0;
+          struct stat st;
+          if(stat(entry.path.c_str(), &st) == 0) {
+            entry.mtime = st.st_mtim.tv_sec;
+            entry.mtimeNs = st.st_mtim.tv_nsec;
+            entry.size = st.st_size;
+          }
+          files.push_back(entry);
+        } else if (file.find(".", 0, 1) != std::string::npos) {
+          // skip ".*"
+        } else {
+          // go into the next dir
+          collectFiles(path + file + "/", files);
+        }
+      }
+      closedir (dir);
+    } else {
+      // this is not a directory
+      fprintf(stderr, "Specified path '%s' is not a valid directory\n",
+              path.c_str());
+    }
+  }
+
+  std::string NodeInfoLoader::FileEntry::fingerprint() const {
+    char buffer[64];
+    snprintf(buffer, 64, "%lu.%09lu:%lu", mtime, mtimeNs, size);
+    return buffer;
+  }
+
+  std::vector<NodeInfoLoader::FileEntry> NodeInfoLoader::listFiles(const std::string &path) {
+    std::vector<FileEntry> files;
+    collectFiles(path, files);
+    return files;
+  }
+
+  std::vector<ConfigMap> NodeInfoLoader::load(const std::vector<FileEntry> &files) {
+    std::vector<ConfigMap> result(files.size());
+    parallelFor(files.size(), [&](size_t i) {
+        try {
+          result[i] = ConfigMap::fromYamlFile(files[i].path);
+        } catch(...) {
+          fprintf(stderr, "ERROR: could not load: %s\n",
+                  files[i].path.c_str());
+        }
+      });
+    return result;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,46 @@
+/**
+ * \file NodeInfoLoader.hpp
+ * \brief Loads the node definition files used to fill the node info catalog
+ *
+ * The yaml files of a folder tree are parsed in parallel. Unchanged files
+ * are not parsed at all on the next start: the node infos generated from
+ * them are taken from the NodeInfoCatalogCache, keyed by path,
+ * modification time and size (see Model::loadNodeInfo()).
+ **/
+
+#ifndef XROCK_GUI_MODEL_NODE_INFO_LOADER_HPP
+#define XROCK_GUI_MODEL_NODE_INFO_LOADER_HPP
+
+#include <configmaps/ConfigMap.hpp>
+
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  class NodeInfoLoader {
+  public:
+    struct FileEntry {
+      std::string path;
+      // the nanoseconds catch edits within the same second
+      unsigned long mtime, mtimeNs, size;
+      std::string fingerprint() const;
+    };
+
+    // returns all yml files found recursively in path; the order is the
+    // directory order of the former serial scan
+    std::vector<FileEntry> listFiles(const std::string &path);
+    // returns the content of the files; files which could not be loaded
+    // result in an empty map
+    std::vector<configmaps::ConfigMap> load(const std::vector<FileEntry> &files);
+    std::vector<configmaps::ConfigMap> load(const std::string &path) {
+      return load(listFiles(path));
+    }
+
+  private:
+    void collectFiles(std::string path, std::vector<FileEntry> &files);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_NODE_INFO_LOADER_HPP
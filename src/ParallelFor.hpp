@@ -0,0 +1,45 @@
+/**
+ * \file ParallelFor.hpp
+ * \brief Runs independent jobs on a small pool of worker threads
+ **/
+
+#ifndef XROCK_GUI_MODEL_PARALLEL_FOR_HPP
+#define XROCK_GUI_MODEL_PARALLEL_FOR_HPP
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  // Calls fn(i) for every i in [0, n). The threads fetch the next job
+  // from a shared counter, so long running jobs don't stall the others.
+  // fn has to be thread safe; the calling thread takes part in the work.
+  inline void parallelFor(size_t n, const std::function<void(size_t)> &fn,
+                          unsigned int maxThreads = 0) {
+    size_t numThreads = maxThreads ? maxThreads : std::thread::hardware_concurrency();
+    if(numThreads > n) numThreads = n;
+    if(numThreads <= 1) {
+      for(size_t i=0; i<n; ++i) fn(i);
+      return;
+    }
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for(size_t i=next++; i<n; i=next++) {
+        fn(i);
+      }
+    };
+    std::vector<std::thread> threads;
+    for(size_t i=1; i<numThreads; ++i) {
+      threads.push_back(std::thread(worker));
+    }
+    worker();
+    for(auto &t: threads) {
+      t.join();
+    }
+  }
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_PARALLEL_FOR_HPP
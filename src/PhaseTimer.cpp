@@ -0,0 +1,157 @@
+#include "PhaseTimer.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace xrock_gui_model {
+
+  std::atomic<bool> PhaseTimer::active(false);
+
+  namespace {
+
+    struct PhaseStats {
+      PhaseStats() : count(0), total(0.0), max(0.0) {}
+      unsigned long count;
+      double total, max;
+    };
+
+    // probes are also used from the db worker threads; only the thread
+    // which started the operation adds to its report, the trace gets all
+    struct Report {
+      Report() : running(false), trace(NULL), traceEvents(0) {}
+      ~Report() {closeTrace();}
+      std::mutex mutex;
+      std::string output;
+      bool running;
+      std::thread::id owner;
+      std::string operation;
+      std::vector<const char*> order;
+      std::unordered_map<std::string, PhaseStats> stats;
+      FILE *trace;
+      unsigned long traceEvents;
+      std::chrono::steady_clock::time_point traceStart;
+
+      void closeTrace() {
+        if(!trace) return;
+        fprintf(trace, "\n]\n");
+        fclose(trace);
+        trace = NULL;
+      }
+    };
+
+    Report& report() {
+      static Report r;
+      return r;
+    }
+
+    // small ids in the order the threads are first seen
+    int threadId() {
+      static std::atomic<int> next(1);
+      thread_local int id = next++;
+      return id;
+    }
+
+    void writeReport(Report &r, double ms) {
+      FILE *file = stderr;
+      if(r.output != "stderr") {
+        file = fopen(r.output.c_str(), "a");
+        if(!file) {
+          fprintf(stderr, "ERROR: could not open timing report: %s\n",
+                  r.output.c_str());
+          return;
+        }
+      }
+      fprintf(file, "timing of %s: %.3f ms\n", r.operation.c_str(), ms);
+      fprintf(file, "  %-28s %8s %12s %12s\n", "phase", "count", "total ms",
+              "max ms");
+      for(auto it: r.order) {
+        PhaseStats &s = r.stats[it];
+        fprintf(file, "  %-28s %8lu %12.3f %12.3f\n", it, s.count, s.total,
+                s.max);
+      }
+      if(file != stderr) {
+        fclose(file);
+      }
+    }
+
+  } // end of anonymous namespace
+
+  PhaseTimer::PhaseTimer(const char *phase, bool operation) :
+    phase(phase), running(active), operation(false) {
+    if(!running) return;
+    if(operation) {
+      Report &r = report();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      if(!r.running) {
+        r.running = true;
+        r.owner = std::this_thread::get_id();
+        r.operation = phase;
+        r.order.clear();
+        r.stats.clear();
+        this->operation = true;
+      }
+    }
+    start = std::chrono::steady_clock::now();
+  }
+
+  PhaseTimer::~PhaseTimer() {
+    if(!running) return;
+    std::chrono::duration<double, std::milli> d = (std::chrono::steady_clock::now() -
+                                                   start);
+    double ms = d.count();
+    Report &r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if(r.trace && start >= r.traceStart) {
+      std::chrono::duration<double, std::micro> ts = start - r.traceStart;
+      fprintf(r.trace, "%s{\"name\":\"%s\",\"cat\":\"xrock\",\"ph\":\"X\","
+              "\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+              r.traceEvents++ ? ",\n" : "", phase, (int)getpid(), threadId(),
+              ts.count(), ms*1000.0);
+    }
+    // probes outside of an operation are not reported
+    if(!r.running || r.owner != std::this_thread::get_id()) return;
+    PhaseStats &s = r.stats[phase];
+    if(s.count++ == 0) {
+      r.order.push_back(phase);
+    }
+    s.total += ms;
+    if(ms > s.max) s.max = ms;
+    if(operation) {
+      if(!r.output.empty()) {
+        writeReport(r, ms);
+      }
+      r.running = false;
+    }
+  }
+
+  void PhaseTimer::setOutput(const std::string &output) {
+    Report &r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.output = output;
+    active = !r.output.empty() || r.trace;
+  }
+
+  void PhaseTimer::setTraceFile(const std::string &filename) {
+    Report &r = report();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.closeTrace();
+    if(!filename.empty()) {
+      r.trace = fopen(filename.c_str(), "w");
+      if(r.trace) {
+        fprintf(r.trace, "[\n");
+        r.traceEvents = 0;
+        r.traceStart = std::chrono::steady_clock::now();
+      }
+      else {
+        fprintf(stderr, "ERROR: could not open trace file: %s\n",
+                filename.c_str());
+      }
+    }
+    active = !r.output.empty() || r.trace;
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,48 @@
+/**
+ * \file PhaseTimer.hpp
+ * \brief Scoped timing probes aggregated per operation
+ *
+ * A PhaseTimer adds the time until it goes out of scope to its phase.
+ * A timer marked as operation starts a new report if no other operation
+ * is running; the count, total and max time of each phase are written
+ * when it ends. Only the probes of the thread that started the operation
+ * are part of its report. With a trace file set, every probe is also written as a
+ * span in Chrome trace event format (chrome://tracing, Perfetto). The
+ * probes do nothing until a report output or a trace file is set.
+ **/
+
+#ifndef XROCK_GUI_MODEL_PHASE_TIMER_HPP
+#define XROCK_GUI_MODEL_PHASE_TIMER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace xrock_gui_model {
+
+  class PhaseTimer {
+  public:
+    // phase has to be a string literal
+    explicit PhaseTimer(const char *phase, bool operation=false);
+    ~PhaseTimer();
+
+    // "" disables the probes, "stderr" prints the reports and any other
+    // value is a file the reports are appended to
+    static void setOutput(const std::string &output);
+    // "" closes the trace
+    static void setTraceFile(const std::string &filename);
+    static bool enabled() {return active;}
+
+  private:
+    static std::atomic<bool> active;
+    const char *phase;
+    bool running, operation;
+    std::chrono::steady_clock::time_point start;
+
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+  };
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_PHASE_TIMER_HPP
@@ -1,4 +1,6 @@
 #include "RestDB.hpp"
+#include "ConfigMapHelper.hpp"
+#include "PhaseTimer.hpp"
 #include <mars/utils/misc.h>
 
 #include <cpr/cpr.h>
@@ -24,6 +26,7 @@ namespace xrock_gui_model {
   }
 
   std::vector<std::pair<std::string, std::string>> RestDB::requestModelListByDomain(const std::string &domain) {
+    PhaseTimer timer("db.requestModelList");
     ConfigMap request;
     request["dbRequest2"]["id"] = 1;
     request["dbRequest2"]["username"] = "nn";
@@ -58,6 +61,7 @@ namespace xrock_gui_model {
 
 
   std::vector<std::string> RestDB::requestVersions(const std::string &domain, const std::string &model) {
+    PhaseTimer timer("db.requestVersions");
     ConfigMap request;
     request["dbRequest2"]["id"] = 1;
     request["dbRequest2"]["username"] = dbUser;
@@ -97,6 +101,7 @@ namespace xrock_gui_model {
                                   const std::string &model,
                                   const std::string &version,
                                   const bool limit) {
+    PhaseTimer timer("db.requestModel");
     ConfigMap request;
     request["dbRequest2"]["id"] = 1;
     request["dbRequest2"]["username"] = dbUser;
@@ -125,13 +130,16 @@ namespace xrock_gui_model {
       return ConfigMap();
     }
     //fprintf(stderr, "\nEND requestModel \n\n");
+    ConfigMapHelper::unpackData(result["results"][0]);
     return result["results"][0];
   }
 
 
   bool RestDB::storeModel(const ConfigMap &map) {
+    PhaseTimer timer("db.storeModel");
     fprintf(stderr, "\nSTART storeModel: \n\n");
     ConfigMap model = map;
+    ConfigMapHelper::packData(model);
     // here we assume that the maps fits to the json representation required by the db
     
     auto t = std::time(nullptr);
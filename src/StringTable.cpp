@@ -0,0 +1,49 @@
+#include "StringTable.hpp"
+
+#include <mars/utils/misc.h>
+
+namespace xrock_gui_model {
+
+  const StringId StringTable::invalid = (StringId)-1;
+
+  StringTable& StringTable::global() {
+    static StringTable table;
+    return table;
+  }
+
+  StringTable::StringTable() {
+    // id 0 is always the empty string
+    intern("");
+  }
+
+  StringId StringTable::intern(const std::string &s) {
+    std::unordered_map<std::string, StringId>::iterator it = ids.find(s);
+    if(it != ids.end()) {
+      return it->second;
+    }
+    StringId id = (StringId)strings.size();
+    // the keys of the map are stable and used as storage of the strings
+    it = ids.insert(std::make_pair(s, id)).first;
+    strings.push_back(&(it->first));
+    lowerIds.push_back(invalid);
+    return id;
+  }
+
+  StringId StringTable::find(const std::string &s) const {
+    std::unordered_map<std::string, StringId>::const_iterator it = ids.find(s);
+    if(it != ids.end()) {
+      return it->second;
+    }
+    return invalid;
+  }
+
+  StringId StringTable::lower(StringId id) {
+    if(lowerIds[id] == invalid) {
+      StringId l = intern(mars::utils::tolower(str(id)));
+      lowerIds[id] = l;
+      lowerIds[l] = l;
+    }
+    return lowerIds[id];
+  }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,55 @@
+/**
+ * \file StringTable.hpp
+ * \brief Interned strings shared by all models
+ *
+ * Names, types, domains and directions repeat very often. They are
+ * stored once and referenced by a StringId, so comparisons become
+ * integer compares. The table is used from the gui thread only.
+ **/
+
+#ifndef XROCK_GUI_MODEL_STRING_TABLE_HPP
+#define XROCK_GUI_MODEL_STRING_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace xrock_gui_model {
+
+  typedef unsigned int StringId;
+
+  class StringTable {
+  public:
+    static const StringId invalid;
+
+    // the table shared by all models
+    static StringTable& global();
+
+    StringTable();
+    // returns the id of the string and adds it if it is unknown
+    StringId intern(const std::string &s);
+    // returns StringTable::invalid if the string is unknown
+    StringId find(const std::string &s) const;
+    const std::string& str(StringId id) const {return *(strings[id]);}
+    size_t size() const {return strings.size();}
+
+    // returns the id of the lower case version of the string; the
+    // conversion is only done once per string
+    StringId lower(StringId id);
+    const std::string& tolower(const std::string &s) {
+      return str(lower(intern(s)));
+    }
+
+  private:
+    std::unordered_map<std::string, StringId> ids;
+    std::vector<const std::string*> strings;
+    std::vector<StringId> lowerIds;
+  };
+
+  inline StringId internString(const std::string &s) {
+    return StringTable::global().intern(s);
+  }
+
+} // end of namespace xrock_gui_model
+
+#endif // XROCK_GUI_MODEL_STRING_TABLE_HPP
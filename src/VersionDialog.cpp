@@ -1,5 +1,6 @@
 #include "VersionDialog.hpp"
 #include "ModelLib.hpp"
+#include "PhaseTimer.hpp"
 #include <mars/config_map_gui/DataWidget.h>
 #include <mars/utils/misc.h>
 
@@ -44,6 +45,7 @@ namespace xrock_gui_model {
 
   void VersionDialog::requestComponent(const std::string &domain,
                                        const std::string &name) {
+    PhaseTimer timer("VersionDialog::requestComponent");
     selectedDomain = domain;
     selectedModel  = name;
     std::vector<std::string> versionList = modelLib->db->requestVersions(domain, name);
@@ -54,6 +56,7 @@ namespace xrock_gui_model {
   }
 
   void VersionDialog::versionClicked(const QModelIndex &index) {
+    PhaseTimer timer("VersionDialog::versionClicked");
     QVariant v = versions->model()->data(index, 0);
     if(v.isValid()) {
       selectedVersion = v.toString().toStdString();
@@ -72,6 +75,7 @@ namespace xrock_gui_model {
   }
 
   void VersionDialog::selectVersion() {
+    PhaseTimer timer("VersionDialog::selectVersion");
     if ( selectedVersion != std::string("") ) {
       modelLib->selectVersion(selectedVersion);
     }
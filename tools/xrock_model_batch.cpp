@@ -0,0 +1,294 @@
+/**
+ * \file xrock_model_batch.cpp
+ * \brief Exports, converts and validates many models without the gui
+ *
+ * The models are processed by a fixed number of worker threads; each
+ * worker holds only the model it works on, so the memory footprint is
+ * bounded by the number of jobs. A summary with the timings is printed
+ * at the end. A model fails if it can't be read or written or if the
+ * validation reports errors; the cnd export also fails if node types are
+ * not found in the database. The exit code is non-zero if any model
+ * failed.
+ **/
+
+#include "ModelFile.hpp"
+#include "CndExport.hpp"
+#include "FileDB.hpp"
+#include "ParallelFor.hpp"
+
+#include <mars/utils/misc.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  Options() : jobs(0) {}
+  std::string command, outputDir, dbAddress;
+  unsigned int jobs;
+  std::vector<std::string> models;
+};
+
+struct Result {
+  Result() : ok(false), loadMs(0), processMs(0), writeMs(0) {}
+  bool ok;
+  double loadMs, processMs, writeMs;
+  std::vector<std::string> messages;
+};
+
+static double msSince(const Clock::time_point &start) {
+  std::chrono::duration<double, std::milli> d = Clock::now() - start;
+  return d.count();
+}
+
+static void usage(const char *name) {
+  fprintf(stderr, "usage: %s [options] <command> <model>...\n", name);
+  fprintf(stderr, "commands:\n"
+          "  cnd       export a cnd file per model\n"
+          "  convert   write yaml models as %s and binary models as .yml\n"
+          "  validate  check the structure of the models\n", ModelFile::binarySuffix);
+  fprintf(stderr, "options:\n"
+          "  -o <dir>   output directory, default is the folder of the model\n"
+          "  -j <n>     number of parallel jobs, default is one per core\n"
+          "  -d <dir>   FileDB for the node types and for models given as\n"
+          "             db:<name>:<version>\n"
+          "  -l <file>  read additional models from a file, one per line\n");
+}
+
+static bool parseOptions(int argc, char **argv, Options &o) {
+  for(int i=1; i<argc; ++i) {
+    std::string arg = argv[i];
+    if(arg.size() == 2 && arg[0] == '-') {
+      if(i+1 >= argc) return false;
+      std::string value = argv[++i];
+      switch(arg[1]) {
+      case 'o': o.outputDir = value; break;
+      case 'j': o.jobs = strtoul(value.c_str(), NULL, 10); break;
+      case 'd': o.dbAddress = value; break;
+      case 'l':
+        {
+          std::ifstream list(value.c_str());
+          if(!list.good()) {
+            fprintf(stderr, "ERROR: could not read %s\n", value.c_str());
+            return false;
+          }
+          std::string line;
+          while(std::getline(list, line)) {
+            line = mars::utils::trim(line);
+            if(!line.empty() && line[0] != '#') o.models.push_back(line);
+          }
+          break;
+        }
+      default:
+        return false;
+      }
+    }
+    else if(o.command.empty()) {
+      o.command = arg;
+    }
+    else {
+      o.models.push_back(arg);
+    }
+  }
+  return ((o.command == "cnd" || o.command == "convert" ||
+           o.command == "validate") && !o.models.empty());
+}
+
+static bool isDBModel(const std::string &source) {
+  return source.compare(0, 3, "db:") == 0;
+}
+
+static std::string modelName(const std::string &source) {
+  std::string name;
+  if(isDBModel(source)) {
+    std::vector<std::string> arr = mars::utils::explodeString(':', source.substr(3));
+    if(!arr.empty()) name = arr[0];
+  }
+  else {
+    name = source;
+    mars::utils::removeFilenamePrefix(&name);
+    mars::utils::removeFilenameSuffix(&name);
+  }
+  return name;
+}
+
+// models from the db are given as db:<name>:<version>
+static bool loadModel(const std::string &source, DBInterface *db,
+                      ConfigMap &model) {
+  if(isDBModel(source)) {
+    std::vector<std::string> arr = mars::utils::explodeString(':', source.substr(3));
+    if(!db || arr.size() != 2) return false;
+    model = db->requestModel("software", arr[0], arr[1], true);
+    return model.hasKey("versions");
+  }
+  return ModelFile::load(source, model);
+}
+
+static std::string outputFile(const Options &o, const std::string &source) {
+  std::string suffix = ".cnd";
+  if(o.command == "convert") {
+    suffix = ModelFile::isBinary(source) ? ".yml" : ModelFile::binarySuffix;
+  }
+  std::string dir = o.outputDir;
+  if(dir.empty()) {
+    dir = isDBModel(source) ? "." : mars::utils::getPathOfFile(source);
+  }
+  if(dir.empty()) dir = ".";
+  return mars::utils::pathJoin(dir, modelName(source) + suffix);
+}
+
+static void process(const Options &o, DBInterface *db,
+                    const std::string &source, const std::string &output,
+                    Result &result) {
+  Clock::time_point start = Clock::now();
+  ConfigMap model;
+  if(!loadModel(source, db, model)) {
+    result.messages.push_back("could not load model");
+    return;
+  }
+  result.loadMs = msSince(start);
+
+  // models with structural errors fail, for the cnd export also models
+  // with unknown types
+  start = Clock::now();
+  bool ok = ModelFile::validate(model, result.messages);
+  if(o.command == "validate") {
+    result.processMs = msSince(start);
+    result.ok = ok;
+    return;
+  }
+  if(o.command == "cnd") {
+    size_t numMessages = result.messages.size();
+    ConfigMap graph = CndExport::createGraphMap(model, db, &result.messages);
+    ok &= result.messages.size() == numMessages;
+    // free the model before the export
+    model = ConfigMap();
+    result.processMs = msSince(start);
+    start = Clock::now();
+    // the shutdown.cnd is written once per folder by main()
+    if(!CndExport::exportCnd(graph, output, false)) {
+      result.messages.push_back("could not write " + output);
+      ok = false;
+    }
+    result.writeMs = msSince(start);
+    result.ok = ok;
+    return;
+  }
+  // convert
+  result.processMs = msSince(start);
+  start = Clock::now();
+  if(!ModelFile::save(model, output)) {
+    result.messages.push_back("could not write " + output);
+    ok = false;
+  }
+  result.ok = ok;
+  result.writeMs = msSince(start);
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  if(!parseOptions(argc, argv, o)) {
+    usage(argv[0]);
+    return 1;
+  }
+  if(!o.outputDir.empty()) {
+    mars::utils::createDirectory(o.outputDir);
+  }
+  FileDB fileDB;
+  DBInterface *db = NULL;
+  if(!o.dbAddress.empty()) {
+    fileDB.set_dbAddress(o.dbAddress);
+    db = &fileDB;
+  }
+
+  std::vector<Result> results(o.models.size());
+  // models writing the same output file are not processed
+  std::vector<std::string> outputs(o.models.size());
+  std::vector<bool> skip(o.models.size(), false);
+  if(o.command != "validate") {
+    std::map<std::string, size_t> owners;
+    for(size_t i=0; i<o.models.size(); ++i) {
+      outputs[i] = outputFile(o, o.models[i]);
+      auto it = owners.insert(std::make_pair(outputs[i], i));
+      if(!it.second) {
+        skip[i] = true;
+        results[i].messages.push_back("output " + outputs[i] + " is already written for " + o.models[it.first->second]);
+      }
+    }
+  }
+
+  std::mutex outputMutex;
+  Clock::time_point start = Clock::now();
+  parallelFor(o.models.size(), [&](size_t i) {
+      if(!skip[i]) {
+        try {
+          process(o, db, o.models[i], outputs[i], results[i]);
+        } catch(std::exception &e) {
+          results[i].ok = false;
+          results[i].messages.push_back(e.what());
+        } catch(...) {
+          results[i].ok = false;
+          results[i].messages.push_back("unknown error");
+        }
+      }
+      std::lock_guard<std::mutex> lock(outputMutex);
+      printf("%s %s\n", results[i].ok ? "ok    " : "failed", o.models[i].c_str());
+      for(auto &it: results[i].messages) {
+        printf("         %s\n", it.c_str());
+      }
+      fflush(stdout);
+    }, o.jobs);
+  if(o.command == "cnd") {
+    std::set<std::string> folders;
+    for(size_t i=0; i<outputs.size(); ++i) {
+      if(!skip[i]) folders.insert(mars::utils::getPathOfFile(outputs[i]));
+    }
+    for(auto &it: folders) {
+      CndExport::writeShutdownCnd(it);
+    }
+  }
+  double wallMs = msSince(start);
+
+  size_t failed = 0;
+  double load = 0, work = 0, write = 0, maxMs = 0;
+  size_t slowest = 0;
+  for(size_t i=0; i<results.size(); ++i) {
+    Result &r = results[i];
+    if(!r.ok) ++failed;
+    load += r.loadMs;
+    work += r.processMs;
+    write += r.writeMs;
+    double ms = r.loadMs + r.processMs + r.writeMs;
+    if(ms > maxMs) {
+      maxMs = ms;
+      slowest = i;
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  unsigned int jobs = o.jobs ? o.jobs : std::thread::hardware_concurrency();
+  printf("\n%s: %lu models, %lu failed, %u jobs\n", o.command.c_str(),
+         (unsigned long)results.size(), (unsigned long)failed, jobs);
+  printf("  wall time   %12.3f ms (%.1f models/s)\n", wallMs,
+         wallMs > 0 ? results.size()/(wallMs/1000.0) : 0.0);
+  printf("  load        %12.3f ms\n", load);
+  printf("  process     %12.3f ms\n", work);
+  printf("  write       %12.3f ms\n", write);
+  printf("  slowest     %12.3f ms %s\n", maxMs, o.models[slowest].c_str());
+  printf("  peak memory %12.1f MB\n", usage.ru_maxrss/1024.0);
+  return failed ? 1 : 0;
+}
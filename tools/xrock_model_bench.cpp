@@ -0,0 +1,369 @@
+/**
+ * \file xrock_model_bench.cpp
+ * \brief Loads, transforms, saves and exports synthetic models
+ *
+ * Runs the gui independent parts of the model handling on generated
+ * graphs and prints time, throughput and memory growth of each step. The
+ * save step converts the graph into a model map like
+ * ModelWidget::saveGraph() does and collects the exported interfaces
+ * with the same InterfaceSet. The save step is repeated for a range of
+ * exported interface counts.
+ **/
+
+#include "ModelGraph.hpp"
+#include "ModelFile.hpp"
+#include "ModelStreamReader.hpp"
+#include "ConfigMapHelper.hpp"
+#include "CndExport.hpp"
+#include "FileDB.hpp"
+#include "InterfaceSet.hpp"
+
+#include <mars/utils/misc.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+struct Options {
+  Options() : nodes(1000), edges(2), ports(4), types(20), repeat(3),
+              interfaces(0), sweep(true), dir("xrock_model_bench") {}
+  unsigned long nodes, edges, ports, types, repeat, interfaces;
+  // measure the save step for several interface counts
+  bool sweep;
+  std::string dir;
+};
+
+static std::string nodeName(unsigned long i) {
+  return "node_" + std::to_string(i);
+}
+
+static std::string typeName(unsigned long i, const Options &o) {
+  return "bench::Task" + std::to_string(i % o.types);
+}
+
+// the graph as the gui holds it: one map per node with ports and data
+// the exported ports are spread evenly over the inputs and outputs of
+// all nodes; port p of list l of node i
+static bool isExported(unsigned long i, int l, unsigned long p,
+                       const Options &o) {
+  if(o.interfaces == 0) return false;
+  unsigned long numPorts = o.nodes*2*o.ports;
+  unsigned long stride = numPorts > o.interfaces ? numPorts/o.interfaces : 1;
+  return (i*2*o.ports + l*o.ports + p) % stride == 0;
+}
+
+static std::string portName(int l, unsigned long p) {
+  return (l ? "out_" : "in_") + std::to_string(p);
+}
+
+static ConfigMap createNodeMap(unsigned long i, const Options &o) {
+  ConfigMap node;
+  node["name"] = nodeName(i);
+  node["type"] = typeName(i, o);
+  node["modelName"] = typeName(i, o);
+  node["modelVersion"] = "v0.0.1";
+  node["domain"] = "software";
+  const char *lists[2] = {"inputs", "outputs"};
+  for(int l=0; l<2; ++l) {
+    for(unsigned long p=0; p<o.ports; ++p) {
+      ConfigMap port;
+      port["name"] = portName(l, p);
+      port["type"] = "/base/samples/Type" + std::to_string(p);
+      port["domain"] = "software";
+      port["direction"] = l ? "OUTGOING" : "INCOMING";
+      if(isExported(i, l, p, o)) {
+        port["interface"] = 1;
+        port["interfaceExportName"] = nodeName(i) + "_" + portName(l, p);
+      }
+      node[lists[l]].push_back(port);
+    }
+  }
+  ConfigMap &config = node["softwareData"]["data"]["configuration"];
+  config["period"] = 0.01;
+  config["name"] = nodeName(i);
+  config["gains"].push_back(ConfigItem(1.0));
+  config["gains"].push_back(ConfigItem(0.5));
+  return node;
+}
+
+static ConfigMap createEdgeMap(unsigned long i, unsigned long k,
+                               const Options &o) {
+  ConfigMap edge;
+  unsigned long port = k % o.ports;
+  edge["fromNode"] = nodeName(i);
+  edge["fromNodeOutput"] = "out_" + std::to_string(port);
+  edge["toNode"] = nodeName((i+1+k) % o.nodes);
+  edge["toNodeInput"] = "in_" + std::to_string(port);
+  edge["name"] = "edge_" + std::to_string(i*o.edges+k);
+  edge["domain"] = "software";
+  edge["transport"] = "CORBA";
+  return edge;
+}
+
+static void buildGraph(ModelGraph &graph, const Options &o) {
+  graph.beginBatch();
+  for(unsigned long i=0; i<o.nodes; ++i) {
+    ConfigMap node = createNodeMap(i, o);
+    graph.addNode(i+1, node);
+  }
+  for(unsigned long i=0; i<o.nodes; ++i) {
+    for(unsigned long k=0; k<o.edges; ++k) {
+      ConfigMap edge = createEdgeMap(i, k, o);
+      graph.addEdge(i*o.edges+k+1, edge);
+    }
+  }
+  graph.endBatch();
+}
+
+// changes the configuration of every tenth node and queries the
+// compatible inputs as the gui does when an edge is drawn
+static size_t transformGraph(ModelGraph &graph, const Options &o) {
+  size_t count = 0;
+  for(unsigned long i=0; i<o.nodes; i+=10) {
+    ConfigMap node = createNodeMap(i, o);
+    node["softwareData"]["data"]["configuration"]["period"] = 0.02;
+    graph.updateNode(i+1, node);
+    count += graph.getCompatibleInputs(i+1, "out_0").size();
+  }
+  return count;
+}
+
+// the model file layout written by ModelWidget::saveGraph()
+static ConfigMap saveGraph(ModelGraph &graph, const Options &o) {
+  ConfigMap model;
+  model["name"] = "bench_model";
+  model["domain"] = "SOFTWARE";
+  model["type"] = "system_modelling::subsystem";
+  ConfigMap &version = model["versions"][0];
+  version["name"] = "v0.0.1";
+  ConfigMap &components = version["components"];
+  components["nodes"] = ConfigVector();
+  components["edges"] = ConfigVector();
+  ConfigMap interfaceMap;
+  InterfaceSet exported(interfaceMap);
+  for(unsigned long i=0; i<o.nodes; ++i) {
+    const ModelGraph::Node *node = graph.getNode(i+1);
+    if(!node) continue;
+    ConfigMap n;
+    n["name"] = graph.str(node->name);
+    n["model"]["name"] = graph.str(node->modelName);
+    n["model"]["domain"] = "SOFTWARE";
+    n["model"]["version"] = graph.str(node->modelVersion);
+    components["nodes"].push_back(n);
+
+    ConfigMap payload = node->payload;
+    if(payload.hasKey("softwareData")) {
+      ConfigMap config;
+      config["name"] = graph.str(node->name);
+      config["data"] = payload["softwareData"]["data"]["configuration"];
+      ConfigMapHelper::packEntry(config);
+      components["configuration"]["nodes"].push_back(config);
+    }
+    // the interface maps as ModelWidget::createNodeFragment() creates them
+    for(int l=0; l<2; ++l) {
+      const ModelGraph::Port *ports = l ? graph.outputs(*node) : graph.inputs(*node);
+      unsigned int numPorts = l ? node->numOutputs : node->numInputs;
+      for(unsigned int p=0; p<numPorts; ++p) {
+        if(!isExported(i, l, p, o)) continue;
+        ConfigMap interface_;
+        interface_["name"] = graph.str(node->name) + "_" + graph.str(ports[p].name);
+        interface_["type"] = graph.str(ports[p].type);
+        interface_["direction"] = l ? "OUTGOING" : "INCOMING";
+        interface_["linkToNode"] = graph.str(node->name);
+        interface_["linkToInterface"] = graph.str(ports[p].name);
+        interface_["domain"] = "SOFTWARE";
+        if(l) exported.addOutput(interface_);
+        else exported.addInput(interface_);
+      }
+    }
+  }
+  if(interfaceMap.hasKey("interfaces")) {
+    version["interfaces"] = interfaceMap["interfaces"];
+  }
+  for(unsigned long i=0; i<o.nodes*o.edges; ++i) {
+    const ModelGraph::Edge *edge = graph.getEdge(i+1);
+    if(!edge) continue;
+    ConfigMap map = graph.edgeToConfigMap(*edge);
+    ConfigMap e;
+    e["name"] = map["name"];
+    e["from"]["name"] = map["fromNode"];
+    e["from"]["interface"] = map["fromNodeOutput"];
+    e["to"]["name"] = map["toNode"];
+    e["to"]["interface"] = map["toNodeInput"];
+    e["data"]["transport"] = map["transport"];
+    ConfigMapHelper::packEntry(e);
+    components["edges"].push_back(e);
+  }
+  return model;
+}
+
+static ConfigMap createBagelMap(const Options &o) {
+  ConfigMap map;
+  for(unsigned long i=0; i<o.nodes; ++i) {
+    map["nodes"].push_back(createNodeMap(i, o));
+    for(unsigned long k=0; k<o.edges; ++k) {
+      map["edges"].push_back(createEdgeMap(i, k, o));
+    }
+  }
+  return map;
+}
+
+static double peakMemory() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // kilobytes on linux
+  return usage.ru_maxrss/1024.0;
+}
+
+// the resident set size of the process in MB
+static double currentMemory() {
+  long pages = 0, resident = 0;
+  FILE *f = fopen("/proc/self/statm", "r");
+  if(f) {
+    if(fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+  }
+  return resident*(double)sysconf(_SC_PAGESIZE)/(1024.0*1024.0);
+}
+
+// runs the step o.repeat times and prints the best time and the growth
+// of the resident memory over the first run
+static void run(const char *name, size_t items, const Options &o,
+                const std::function<void()> &step) {
+  double best = -1, rss = 0;
+  for(unsigned long r=0; r<o.repeat; ++r) {
+    double before = currentMemory();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    step();
+    std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+    if(best < 0 || d.count() < best) best = d.count();
+    if(r == 0) rss = currentMemory() - before;
+  }
+  double rate = best > 0 ? items/(best/1000.0) : 0.0;
+  printf("%-16s %12.3f %14.0f %12.1f\n", name, best, rate, rss);
+}
+
+static void usage(const char *name) {
+  fprintf(stderr, "usage: %s [-n nodes] [-e edges per node] [-p ports] "
+          "[-t types] [-x exported interfaces] [-r repeat] [-o dir]\n"
+          "without -x the save step is measured for 0 to all ports exported\n", name);
+}
+
+int main(int argc, char **argv) {
+  Options o;
+  for(int i=1; i<argc; ++i) {
+    if(i+1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+      usage(argv[0]);
+      return 1;
+    }
+    const char *value = argv[++i];
+    switch(argv[i-1][1]) {
+    case 'n': o.nodes = strtoul(value, NULL, 10); break;
+    case 'e': o.edges = strtoul(value, NULL, 10); break;
+    case 'p': o.ports = strtoul(value, NULL, 10); break;
+    case 't': o.types = strtoul(value, NULL, 10); break;
+    case 'r': o.repeat = strtoul(value, NULL, 10); break;
+    case 'x':
+      o.interfaces = strtoul(value, NULL, 10);
+      o.sweep = false;
+      break;
+    case 'o': o.dir = value; break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if(o.nodes == 0 || o.ports == 0 || o.types == 0 || o.repeat == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+  if(o.sweep) {
+    o.interfaces = o.nodes/10;
+  }
+  mars::utils::createDirectory(o.dir);
+  std::string yamlFile = mars::utils::pathJoin(o.dir, "model.yml");
+  std::string binaryFile = mars::utils::pathJoin(o.dir, std::string("model")+ModelFile::binarySuffix);
+  std::string cndFile = mars::utils::pathJoin(o.dir, "model.cnd");
+  std::string dbDir = mars::utils::pathJoin(o.dir, "db");
+  mars::utils::createDirectory(dbDir);
+  std::ofstream(mars::utils::pathJoin(dbDir, "info.yml").c_str()) << "models: []\n";
+
+  size_t items = o.nodes + o.nodes*o.edges;
+  printf("%lu nodes, %lu edges, %lu ports per direction, %lu types, "
+         "%lu exported interfaces\n", o.nodes, o.nodes*o.edges, o.ports,
+         o.types, o.interfaces);
+  printf("%-16s %12s %14s %12s\n", "step", "best ms", "items/s", "rss +MB");
+
+  std::unique_ptr<ModelGraph> graph;
+  ConfigMap model;
+  run("build graph", items, o, [&]() {
+      graph.reset(new ModelGraph());
+      buildGraph(*graph, o);
+    });
+  run("transform", o.nodes/10+1, o, [&]() {transformGraph(*graph, o);});
+  run("save graph", items, o, [&]() {model = saveGraph(*graph, o);});
+  run("write yaml", items, o, [&]() {
+      ConfigMap m = model;
+      ModelFile::save(m, yamlFile);
+    });
+  run("write binary", items, o, [&]() {
+      ConfigMap m = model;
+      ModelFile::save(m, binaryFile);
+    });
+  run("read yaml", items, o, [&]() {
+      ConfigMap m;
+      ModelFile::load(yamlFile, m);
+    });
+  run("read binary", items, o, [&]() {
+      ConfigMap m;
+      ModelFile::load(binaryFile, m);
+    });
+  run("stream yaml", items, o, [&]() {
+      std::ifstream in(yamlFile.c_str());
+      size_t count = 0;
+      ModelStreamReader::read(in, [&](const std::string &list,
+                                      const std::string &item) {
+                                ConfigMap m = ConfigMap::fromYamlString(item);
+                                count += m.size();
+                              }, ModelStreamReader::ScalarCallback(), NULL);
+    });
+  FileDB db;
+  db.set_dbAddress(dbDir);
+  run("store db", items, o, [&]() {db.storeModel(model);});
+  run("request db", items, o, [&]() {
+      db.requestModel("software", model["name"], "v0.0.1", true);
+    });
+  ConfigMap bagelMap = createBagelMap(o);
+  run("export cnd", items, o, [&]() {CndExport::exportCnd(bagelMap, cndFile);});
+
+  // save time over the number of exported interfaces
+  std::vector<unsigned long> counts;
+  if(o.sweep) {
+    unsigned long numPorts = o.nodes*2*o.ports;
+    counts = {0, numPorts/100, numPorts/10, numPorts/2, numPorts};
+  }
+  else {
+    counts.push_back(o.interfaces);
+  }
+  printf("\n%-16s %12s %14s %12s\n", "interfaces", "best ms", "items/s", "rss +MB");
+  for(auto count: counts) {
+    Options so = o;
+    so.interfaces = count;
+    std::unique_ptr<ModelGraph> sweepGraph(new ModelGraph());
+    buildGraph(*sweepGraph, so);
+    std::string name = std::to_string(count);
+    run(name.c_str(), items, so, [&]() {saveGraph(*sweepGraph, so);});
+  }
+  printf("\npeak memory of the process %.1f MB\n", peakMemory());
+  return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * \file xrock_model_convert.cpp
+ * \brief Converts model files between yaml and the binary .xmb format
+ **/
+
+#include "ModelFile.hpp"
+
+#include <cstdio>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+int main(int argc, char **argv) {
+  if(argc != 3) {
+    fprintf(stderr, "usage: %s <input> <output>\n", argv[0]);
+    fprintf(stderr, "  the format is selected by the file extension, %s files\n"
+            "  are binary, all others yaml\n", ModelFile::binarySuffix);
+    return 1;
+  }
+  ConfigMap model;
+  if(!ModelFile::load(argv[1], model)) {
+    fprintf(stderr, "ERROR: could not load %s\n", argv[1]);
+    return 1;
+  }
+  if(!ModelFile::save(model, argv[2])) {
+    fprintf(stderr, "ERROR: could not write %s\n", argv[2]);
+    return 1;
+  }
+  return 0;
+}